@@ -37,6 +37,11 @@
 #   include <pthread.h>
 #endif
 
+// mmap
+#if __has_include(<sys/mman.h>)
+#   include <sys/mman.h>
+#endif
+
 // time
 #if __has_include(<sys/time.h>)
 #   include <sys/time.h>
@@ -1,18 +1,22 @@
 #pragma once
 
 #include "ustd/core/builtin.h"
+#include "ustd/core/arena.h"
 #include "ustd/core/boxed.h"
 #include "ustd/core/enum.h"
 #include "ustd/core/fmt.h"
 #include "ustd/core/fn.h"
+#include "ustd/core/hash.h"
 #include "ustd/core/iter.h"
 #include "ustd/core/list.h"
+#include "ustd/core/map.h"
 #include "ustd/core/mem.h"
 #include "ustd/core/num.h"
 #include "ustd/core/ops.h"
 #include "ustd/core/option.h"
 #include "ustd/core/panic.h"
 #include "ustd/core/result.h"
+#include "ustd/core/slab.h"
 #include "ustd/core/slice.h"
 #include "ustd/core/str.h"
 #include "ustd/core/tuple.h"
@@ -0,0 +1,276 @@
+#include "config.inl"
+
+namespace ustd
+{
+
+static thread_local Arena::Scope* _tls_scope = nullptr;
+
+static fn chunk_begin(Arena::Chunk* chunk) noexcept -> u8* {
+    return reinterpret_cast<u8*>(chunk + 1);
+}
+
+static fn chunk_end(Arena::Chunk* chunk) noexcept -> u8* {
+    return chunk_begin(chunk) + chunk->_size;
+}
+
+#pragma region page map
+// 64KB page -> chunk, two levels over 48 bit addresses like the slab page map, nullptr for memory of others
+static constexpr let $page_bits = 16u;
+static constexpr let $leaf_bits = 16u;
+static constexpr let $root_bits = 48u - $page_bits - $leaf_bits;
+
+static Arena::Chunk** _page_map[1u << $root_bits];
+
+static fn page_chunk(const void* ptr) noexcept -> Arena::Chunk* {
+    let addr = u64(ptr);
+    if ((addr >> 48) != 0) {
+        return nullptr;
+    }
+
+    let leaf = sync::load(&_page_map[addr >> ($page_bits + $leaf_bits)], sync::Ordering::Acquire);
+    if (leaf == nullptr) {
+        return nullptr;
+    }
+    return sync::load(&leaf[(addr >> $page_bits) & ((1u << $leaf_bits) - 1)], sync::Ordering::Acquire);
+}
+
+// every page of `chunk` maps to `val`
+static fn page_set(Arena::Chunk* chunk, Arena::Chunk* val) noexcept -> void {
+    let beg = u64(chunk);
+    let end = u64(chunk_end(chunk));
+    for (mut addr = beg; addr < end; addr += Arena::$page) {
+        mut& root = _page_map[addr >> ($page_bits + $leaf_bits)];
+
+        mut leaf = sync::load(&root, sync::Ordering::Acquire);
+        if (leaf == nullptr) {
+            let bytes = sizeof(Arena::Chunk*) << $leaf_bits;
+            mut tmp   = static_cast<Arena::Chunk**>(::__builtin_operator_new(bytes));
+            ustd_builtin(memset)(tmp, 0, bytes);
+            if (sync::compare_exchange(&root, static_cast<Arena::Chunk**>(nullptr), tmp)) {
+                leaf = tmp;
+            }
+            else {
+                ::__builtin_operator_delete(tmp);
+                leaf = sync::load(&root, sync::Ordering::Acquire);
+            }
+        }
+        sync::store(&leaf[(addr >> $page_bits) & ((1u << $leaf_bits) - 1)], val, sync::Ordering::Release);
+    }
+}
+
+static fn chunk_free(Arena::Chunk* chunk) noexcept -> void {
+    page_set(chunk, nullptr);
+    ::__builtin_operator_delete(chunk->_raw);
+}
+#pragma endregion
+
+#pragma region ctor/dtor
+pub Arena::~Arena() noexcept {
+    free_chunks(nullptr);
+}
+
+pub fn Arena::with_capacity(u64 capacity) noexcept -> Arena {
+    mut res = Arena();
+    res._next_size = ustd::max(capacity, u64(256));
+    res.alloc_slow(0, $align);
+    res._next_size = ustd::max(res._next_size, $min_chunk);
+    return res;
+}
+#pragma endregion
+
+#pragma region method
+pub fn Arena::alloc_slow(u64 size, u64 align) noexcept -> void* {
+    // whole pages, so no page holds memory of another chunk or of the heap
+    let need  = size + align + sizeof(Chunk);
+    let bytes = (ustd::max(_next_size, need) + $page - 1) & ~($page - 1);
+
+    mut raw = static_cast<void*>(nullptr);
+    try {
+        raw = ::__builtin_operator_new(bytes + $page);
+    }
+    catch (...) {
+        log::error("ustd::Arena[{}].alloc(size={}) -> Error(`out of memory`)", this, size);
+        return nullptr;
+    }
+
+    mut chunk = reinterpret_cast<Chunk*>((u64(raw) + $page - 1) & ~($page - 1));
+    chunk->_prev  = _chunk;
+    chunk->_size  = bytes - sizeof(Chunk);
+    chunk->_owner = this;
+    chunk->_raw   = raw;
+    page_set(chunk, chunk);
+
+    _chunk     = chunk;
+    _pos       = chunk_begin(chunk);
+    _end       = chunk_end(chunk);
+    _last      = nullptr;
+    _next_size = ustd::min(_next_size * 2, $max_chunk);
+
+    return alloc(size, align);
+}
+
+pub fn Arena::used() const noexcept -> u64 {
+    if (_chunk == nullptr) {
+        return 0;
+    }
+
+    mut res = u64(_pos - chunk_begin(_chunk));
+    for (mut chunk = _chunk->_prev; chunk != nullptr; chunk = chunk->_prev) {
+        res += chunk->_size;
+    }
+    return res;
+}
+
+pub fn Arena::reset() noexcept -> void {
+    if (_chunk == nullptr) {
+        return;
+    }
+
+    // the newest chunk is the largest one
+    mut prev = _chunk->_prev;
+    _chunk->_prev = nullptr;
+    while (prev != nullptr) {
+        let next = prev->_prev;
+        chunk_free(prev);
+        prev = next;
+    }
+
+    _pos  = chunk_begin(_chunk);
+    _end  = chunk_end(_chunk);
+    _last = nullptr;
+}
+
+pub fn Arena::rewind(Mark mark) noexcept -> void {
+    free_chunks(mark._chunk);
+
+    _chunk = mark._chunk;
+    _pos   = mark._pos;
+    _end   = _chunk == nullptr ? nullptr : chunk_end(_chunk);
+    _last  = nullptr;
+}
+
+fn Arena::free_chunks(Chunk* until) noexcept -> void {
+    while (_chunk != nullptr && _chunk != until) {
+        let prev = _chunk->_prev;
+        chunk_free(_chunk);
+        _chunk = prev;
+    }
+}
+#pragma endregion
+
+#pragma region current
+pub fn Arena::current() noexcept -> Arena* {
+    let scope = _tls_scope;
+    return scope == nullptr ? nullptr : scope->_arena;
+}
+
+pub fn Arena::owner(const void* ptr) noexcept -> Arena* {
+    let chunk = page_chunk(ptr);
+    return chunk == nullptr ? nullptr : chunk->_owner;
+}
+
+pub Arena::Scope::Scope(Arena* arena) noexcept
+    : _arena(arena), _outer(_tls_scope)
+{
+    _tls_scope = this;
+}
+
+pub Arena::Scope::~Scope() noexcept {
+    _tls_scope = _outer;
+}
+#pragma endregion
+
+unittest(Arena) {
+    mut arena = Arena::with_capacity(1024);
+
+    let a = arena.alloc_n<u32>(10);
+    let b = arena.alloc_n<u64>(10);
+    assert_eq(arena.contains(a), true);
+    assert_eq(arena.contains(b), true);
+    assert_eq(u64(b) % 16, u64(0));
+
+    // the latest block is rolled back
+    assert_eq(arena.free(b), true);
+    let c = arena.alloc_n<u64>(10);
+    assert_eq(c == b, true);
+
+    // grow past the first chunk
+    let big = arena.alloc(1 << 20);
+    assert_eq(arena.contains(big), true);
+    assert_eq(arena.used() >= (1u << 20), true);
+
+    arena.reset();
+    assert_eq(arena.used(), u64(0));
+    assert_eq(arena.contains(a), false);
+}
+
+unittest(Arena_scope) {
+    mut outer = Arena();
+    mut inner = Arena();
+    assert_eq(Arena::current() == nullptr, true);
+
+    {
+        let scope0 = Arena::Scope(outer);
+        mut v = List<u32>::with_capacity(100);
+        v.push(1u);
+        assert_eq(outer.contains(v._data), true);
+
+        {
+            let scope1 = Arena::Scope(inner);
+            assert_eq(Arena::current() == &inner, true);
+
+            mut b = Box<u64>(42u);
+            assert_eq(inner.contains(b._ptr), true);
+
+            // a block of the outer arena, dropped in the inner scope
+            {
+                mut moved = as_mov(v);
+                (void)moved;
+            }
+
+            let mark = inner.mark();
+            let tmp  = inner.alloc(100);
+            inner.rewind(mark);
+            assert_eq(inner.alloc(100) == tmp, true);
+        }
+        assert_eq(Arena::current() == &outer, true);
+    }
+    assert_eq(Arena::current() == nullptr, true);
+
+    // heap scope inside an arena scope
+    {
+        let scope0 = Arena::Scope(outer);
+        let scope1 = Arena::Scope(nullptr);
+        assert_eq(Arena::current() == nullptr, true);
+        mut v = List<u32>::with_capacity(10);
+        assert_eq(outer.contains(v._data), false);
+    }
+
+    // outside of a scope, mnew goes to the heap
+    mut h = List<u32>::with_capacity(10);
+    assert_eq(outer.contains(h._data), false);
+
+    // blocks that outlive their scope are dropped and resized as arena memory, not by the C heap
+    mut late = Arena();
+    mut v = [&] {
+        let scope = Arena::Scope(late);
+        return List<u32>::with_capacity(4);
+    }();
+    mut b = [&] {
+        let scope = Arena::Scope(late);
+        return Box<u64>(7u);
+    }();
+    assert_eq(Arena::owner(v._data) == &late, true);
+    for (mut i = 0u; i < 1000; ++i) {
+        v.push(i);
+    }
+    assert_eq(v[999], 999u);
+    assert_eq(late.contains(v._data), false);
+
+    // moved arenas keep their blocks
+    mut moved = as_mov(late);
+    assert_eq(Arena::owner(b._ptr) == &moved, true);
+    b.forget();
+}
+
+}
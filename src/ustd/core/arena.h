@@ -0,0 +1,158 @@
+#pragma once
+
+#include "ustd/core/builtin.h"
+
+namespace ustd
+{
+
+// arena: region allocator, O(1) bump allocation, everything goes back at once with `reset` or the dtor.
+//  - `Arena::Scope` makes an arena current on this thread, `mnew` then allocates from it,
+//    so List, Box, FnBox, NDArray and serialization::Tree need no allocator parameter
+//  - `mdel` of arena memory is a no-op, except for the latest block, which is rolled back;
+//    chunks are 64KB aligned and registered in a page map, so this holds whatever scope is open,
+//    also for blocks dropped after their scope ended
+//  - scopes nest, blocks of an outer arena stay valid in inner scopes
+//  - arena memory must be dropped on the allocating thread, and not be used or dropped after `reset`
+//    or the dtor; jobs pushed to thread::Pool and spawned threads are allocated on the heap
+class Arena
+{
+public:
+    struct Chunk
+    {
+        Chunk*  _prev;
+        u64     _size;      // bytes after the header
+        Arena*  _owner;
+        void*   _raw;       // block of operator new, the chunk starts at its first 64KB boundary
+    };
+
+    // position in an arena, see `mark` and `rewind`
+    struct Mark
+    {
+        Chunk*  _chunk;
+        u8*     _pos;
+    };
+
+    constexpr static let $align     = u64(16);
+    constexpr static let $min_chunk = u64(64) << 10;
+    constexpr static let $max_chunk = u64(64) << 20;
+    constexpr static let $page      = u64(64) << 10;    // chunk alignment, granule of the page map
+
+    Chunk*  _chunk;         // newest chunk
+    u8*     _pos;
+    u8*     _end;
+    u8*     _last;          // latest block
+    u64     _next_size;     // size of the next chunk
+
+#pragma region ctor/dtor
+    // ctor: no memory until the first alloc
+    Arena() noexcept
+        : _chunk(nullptr), _pos(nullptr), _end(nullptr), _last(nullptr), _next_size($min_chunk)
+    {}
+
+    Arena(Arena&& other) noexcept
+        : _chunk(other._chunk), _pos(other._pos), _end(other._end), _last(other._last), _next_size(other._next_size)
+    {
+        for (mut chunk = _chunk; chunk != nullptr; chunk = chunk->_prev) {
+            chunk->_owner = this;
+        }
+        other._chunk = nullptr;
+        other._pos   = nullptr;
+        other._end   = nullptr;
+        other._last  = nullptr;
+    }
+
+    pub ~Arena() noexcept;
+
+    // ctor: first chunk of `capacity` bytes
+    pub static fn with_capacity(u64 capacity) noexcept -> Arena;
+#pragma endregion
+
+#pragma region method
+    // method: `size` bytes aligned to `align` (power of 2), nullptr when out of memory
+    fn alloc(u64 size, u64 align = $align) noexcept -> void* {
+        let pos = reinterpret_cast<u8*>((reinterpret_cast<u64>(_pos) + align - 1) & ~(align - 1));
+        if (_pos == nullptr || pos + size > _end) {
+            return alloc_slow(size, align);
+        }
+        _pos  = pos + size;
+        _last = pos;
+        return pos;
+    }
+
+    template<class T>
+    fn alloc_n(u64 cnt) noexcept -> T* {
+        let align = alignof(T) > $align ? u64(alignof(T)) : $align;
+        return static_cast<T*>(alloc(sizeof(T) * cnt, align));
+    }
+
+    // method: true if `ptr` is memory of this arena, the latest block is given back
+    fn free(void* ptr) noexcept -> bool {
+        if (ptr == nullptr || owner(ptr) != this) {
+            return false;
+        }
+        if (ptr == _last) {
+            _pos  = _last;
+            _last = nullptr;
+        }
+        return true;
+    }
+
+    // method: resize the latest block in place, false for other blocks or when the chunk is full
+    fn resize(void* ptr, u64 size) noexcept -> bool {
+        let p = static_cast<u8*>(ptr);
+        if (p == nullptr || p != _last || p + size > _end) {
+            return false;
+        }
+        _pos = p + size;
+        return true;
+    }
+
+    fn contains(const void* ptr) const noexcept -> bool {
+        return ptr != nullptr && owner(ptr) == this;
+    }
+
+    // method: bytes handed out since the last reset
+    pub fn used() const noexcept -> u64;
+
+    // method: drop every block, keep the newest (largest) chunk for reuse
+    pub fn reset() noexcept -> void;
+
+    fn mark() const noexcept -> Mark {
+        return { _chunk, _pos };
+    }
+
+    // method: drop the blocks allocated after `mark`
+    pub fn rewind(Mark mark) noexcept -> void;
+#pragma endregion
+
+#pragma region current
+    // the current arena of this thread, nullptr outside of any scope
+    pub static fn current() noexcept -> Arena*;
+
+    // the arena that `ptr` belongs to, nullptr for other memory, one page map lookup
+    pub static fn owner(const void* ptr) noexcept -> Arena*;
+
+    // scope: `arena` is current until the scope ends,
+    //  `Scope(nullptr)` sends `mnew` back to the heap, for memory that leaves the thread
+    class Scope
+    {
+    public:
+        Arena*  _arena;
+        Scope*  _outer;
+
+        explicit Scope(Arena& arena) noexcept : Scope(&arena)
+        {}
+
+        pub explicit Scope(Arena* arena) noexcept;
+        pub ~Scope() noexcept;
+
+        Scope(Scope&&) = delete;
+    };
+#pragma endregion
+
+private:
+    pub fn alloc_slow(u64 size, u64 align) noexcept -> void*;
+    fn free_chunks(Chunk* until) noexcept -> void;
+};
+
+}
@@ -12,6 +12,8 @@ class Box final
 public:
     T*  _ptr = nullptr;
 
+    constexpr static let $relocatable = true;
+
     Box() = default;
 
     template<typename ...U>
@@ -3,6 +3,7 @@
 #pragma clang diagnostic ignored "-Wc++17-extensions"
 #pragma clang diagnostic ignored "-Wunused-local-typedef"
 #pragma clang diagnostic ignored "-Wmicrosoft-union-member-reference"
+#pragma clang diagnostic ignored "-Wgnu-string-literal-operator-template"
 
 #if defined(_MSC_VERR) && defined(__INTELLISENSE__)
 #   define USTD_MSVC_INTELLISENSE   1
@@ -30,6 +31,11 @@
 /* fn */
 #define fn  auto
 
+/* USTD_SIZE64: 1 for 64 bit lengths of Slice, List and String, 0 for 32 bit lengths (smaller) */
+#ifndef USTD_SIZE64
+#   define USTD_SIZE64 0
+#endif
+
 /* builtin */
 #ifdef USTD_MSVC_INTELLISENSE
 #   define ustd_builtin(f) ::f
@@ -66,6 +72,13 @@ using i64 = __INT64_TYPE__;    using u64 = __UINT64_TYPE__;
 using f32 = float;
 using f64 = double;
 
+// length of Slice, List and String, see USTD_SIZE64
+#if USTD_SIZE64
+using usize = u64;
+#else
+using usize = u32;
+#endif
+
 using byte = i8;
 using llong = long long;
 
@@ -130,6 +143,20 @@ struct trivial
     static constexpr let $dtor = __has_trivial_destructor(T);
     static constexpr let $assign = __has_trivial_assign(T);
 };
+
+// trivially_relocatable: a T may be moved to new memory with memcpy, the old bytes are not destroyed
+//  - trivially copyable and destructible types are, others opt in with `constexpr static let $relocatable = true;`
+template<class T, class = void>
+struct trivially_relocatable
+{
+    static constexpr let $value = trivial<T>::$copy && trivial<T>::$dtor;
+};
+
+template<class T>
+struct trivially_relocatable<T, when<T::$relocatable>>
+{
+    static constexpr let $value = true;
+};
 #pragma endregion
 
 #pragma region trait
@@ -19,18 +19,155 @@ struct FmtStyle
     u8  _type       = 0;    // [a-Z]
 
     u8  _spec_len   = 0;    // [0~11]
-    i8  _spec[9];           // [...]
+    i8  _spec[9]    = {};   // [...]
 
     fn spec() const noexcept -> str {
         return str(reinterpret_cast<const char*>(_spec), _spec_len);
     }
 
-    static pub fn from_str(str s) noexcept -> FmtStyle;
+    // [[fill]align][sign][width]['.'precision][type][':'spec], `text` is followed by the closing '}'
+    constexpr static fn from_str(str text) noexcept -> FmtStyle {
+        mut res = FmtStyle{};
+        res._fill = ' ';
+
+        if (text._size == 0) {
+            return res;
+        }
+
+        mut p = text._data;
+
+        // [[fill]align]
+        if (p[1] == '>' || p[1] == '<' || p[1] == '^') {
+            res._fill = *p++;
+            res._align = *p++;
+        }
+        else if (*p == '>' || *p == '<' || *p == '^') {
+            res._fill = ' ';
+            res._align = *p++;
+        }
+
+        // [sign]
+        if (*p == '+' || *p == '-' || *p == ' ') {
+            res._sign = *p++;
+        }
+
+        // [width]
+        res._width = 0;
+        while ('0' <= *p && *p <= '9') {
+            res._width = u8(res._width * 10 + ((*p++) - '0'));
+        }
+
+        // [prec]
+        if (*p == '.') {
+            ++p;
+
+            res._prec = 0;
+            while ('0' <= p[0] && p[0] <= '9') {
+                res._prec = u8(res._prec * 10 + ((*p++) - '0'));
+            }
+        }
+
+        // [type]
+        if (*p != '}' && *p != ':') {
+            res._type = u8(*p++);
+        }
+
+        // [spec]
+        if (*p == ':') {
+            ++p;
+
+            mut& idx = res._spec_len;
+            mut& dst = res._spec;
+            for (idx = 0; idx < sizeof(_spec) - 1 && p[idx] != '}'; ++idx) {
+                dst[idx] = p[idx];
+            }
+        }
+
+        return res;
+    }
+};
+
+#pragma region FmtStr
+// _FmtSplit: a format string cut at its placeholders, `{{` and `}}` already unescaped
+//  - chunk i is `_text[_ends[i-1], _ends[i])`, placeholder i sits between chunk i and i+1
+template<u32 N>
+struct _FmtSplit
+{
+    constexpr static let $max_args = N / 2 + 1;
+
+    char     _text[N + 1]           = {};
+    u32      _ends[$max_args + 1]   = {};
+    FmtStyle _styles[$max_args]     = {};
+    u32      _args                  = 0;
 };
 
+// same rules as the run time parser `_sformat_parse`, an unclosed `{` ends the text
+template<u32 N>
+constexpr fn _fmt_split(const char* s) noexcept -> _FmtSplit<N> {
+    mut res = _FmtSplit<N>{};
+    mut len = 0u;
+
+    for (mut i = 0u; i < N; ++i) {
+        let c = s[i];
+        if (c == '{' && i + 1 < N && s[i + 1] == '{') {
+            res._text[len++] = '{';
+            ++i;
+        }
+        else if (c == '{') {
+            mut j = i + 1;
+            while (j < N && s[j] != '}') ++j;
+            if (j == N) break;
+
+            res._ends[res._args]   = len;
+            res._styles[res._args] = FmtStyle::from_str(str{ s + i + 1, j - i - 1 });
+            res._args += 1;
+            i = j;
+        }
+        else if (c == '}') {
+            if (i + 1 < N && s[i + 1] == '}') {
+                res._text[len++] = '}';
+                ++i;
+            }
+        }
+        else {
+            res._text[len++] = c;
+        }
+    }
+    res._ends[res._args] = len;
+    return res;
+}
+
+// FmtStr: a format string parsed at compile time, `"x = {}"_fmt`
+//  - sformat appends its chunks and arguments in a straight line, no parsing at run time
+//  - the number of `{}` must match the number of arguments, checked at compile time
+template<char ...C>
+struct FmtStr
+{
+    constexpr static char $text[]  = { C..., '\0' };
+    constexpr static let  $split   = _fmt_split<sizeof...(C)>($text);
+    constexpr static let  $args    = $split._args;
+
+    // convert: run time format string
+    constexpr operator str() const noexcept {
+        return str{ $text, sizeof...(C) };
+    }
+};
+
+inline namespace literals
+{
+template<class T, T ...C>
+constexpr fn operator""_fmt() noexcept -> FmtStr<C...> {
+    return {};
+}
+}
+#pragma endregion
+
 template<typename ...T>
 fn sformat(StrView& outbuf, str fmt, const T& ...args) noexcept->StrView;
 
+template<char ...C, typename ...T>
+fn sformat(StrView& outbuf, FmtStr<C...> fmt, const T& ...args) noexcept->StrView;
+
 class Formatter
 {
 public:
@@ -69,6 +206,11 @@ public:
         sformat(_outbuf, fmt, u...);
     }
 
+    template<char ...C, typename ...U>
+    fn write_fmt(FmtStr<C...> fmt, const U& ...u) -> void {
+        sformat(_outbuf, fmt, u...);
+    }
+
 private:
 #pragma region level 4
     template<class T, class=when<trait<T>::$num || $is_same<T, bool> > >
@@ -319,6 +461,21 @@ fn _sformat_index(StrView& outbuf, str fmtstr, i32 idx, const T& t, const U& ...
         _sformat_index(outbuf, fmtstr, idx - 1, args...);
     }
 }
+
+template<class F, u32 I>
+fn _sformat_chunk(StrView& outbuf) noexcept -> void {
+    constexpr let beg = I == 0 ? 0u : F::$split._ends[I - 1];
+    constexpr let end = F::$split._ends[I];
+    if constexpr (beg != end) {
+        outbuf.push_slice(str{ F::$split._text + beg, end - beg });
+    }
+}
+
+template<class F, u32 ...I, class ...T>
+fn _sformat_fixed(StrView& outbuf, immut_t<u32, I...>, const T& ...args) noexcept -> void {
+    ((_sformat_chunk<F, I>(outbuf), Formatter(F::$split._styles[I], outbuf)(args)), ...);
+    _sformat_chunk<F, u32(sizeof...(I))>(outbuf);
+}
 #pragma endregion
 
 template<typename ...T>
@@ -338,6 +495,14 @@ fn sformat(StrView& outbuf, str fmt, const T& ...args) noexcept -> StrView {
     return outbuf;
 }
 
+template<char ...C, typename ...T>
+fn sformat(StrView& outbuf, FmtStr<C...>, const T& ...args) noexcept -> StrView {
+    static_assert(FmtStr<C...>::$args == sizeof...(T), "ustd::sformat: the number of `{}` and of arguments differ");
+
+    _sformat_fixed<FmtStr<C...>>(outbuf, seq_t<u32(sizeof...(T))>{}, args...);
+    return outbuf;
+}
+
 template<u32 N, typename ...T>
 fn snformat(const str& fmt, const T& ...args) noexcept -> FixedStr<N> {
     FixedStr<N> outbuf;
@@ -345,6 +510,13 @@ fn snformat(const str& fmt, const T& ...args) noexcept -> FixedStr<N> {
     return as_mov(outbuf);
 }
 
+template<u32 N, char ...C, typename ...T>
+fn snformat(FmtStr<C...> fmt, const T& ...args) noexcept -> FixedStr<N> {
+    FixedStr<N> outbuf;
+    ustd::sformat(outbuf, fmt, args...);
+    return as_mov(outbuf);
+}
+
 template<class T, class ...U>
 fn println(const str& fmt, const T& t, const U& ...u) noexcept -> void {
     let outstr = snformat<4*1024>(fmt, t, u...);
@@ -0,0 +1,86 @@
+#include "config.inl"
+
+namespace ustd
+{
+
+pub fn hash_seed() noexcept -> u64 {
+    static let seed = [] {
+        let var = env::var("USTD_HASH_SEED");
+        if (!var.is_empty()) {
+            let val = str_parse<u64>(var);
+            if (val.is_some()) {
+                return val._val;
+            }
+        }
+
+        // time and ASLR addresses
+        mut local = 0;
+        mut res   = time::Instant::now().total_nanos();
+        res = hash_mix(res ^ u64(&local));
+        res = hash_mix(res ^ u64(&hash_seed));
+        return res;
+    }();
+    return seed;
+}
+
+unittest(hash) {
+    // compile time and run time agree
+    constexpr let h0 = hash("ustd::hash");
+    static_assert(h0 != hash("ustd::hasi"));
+
+    mut buf = FixedStr<64>();
+    buf.push_slice(str("ustd::hash"));
+    assert_eq(hash(str(buf)), h0);
+
+    assert_eq(hash(str("ustd::hash"), 1) != h0, true);
+    assert_eq(hash(str()) != hash(str("a")), true);
+
+    // every length path, one changed byte changes the hash
+    char text[200] = {};
+    for (mut len = 1u; len < 200; ++len) {
+        let h1 = hash(str(text, len));
+        text[len - 1] = 'x';
+        let h2 = hash(str(text, len));
+        text[len - 1] = 0;
+        assert_eq(h1 != h2, true);
+    }
+
+    // low and high bits of short keys, used by the swiss table
+    mut lo = HashSet<u64>::with_capacity(1 << 16);
+    mut hi = HashSet<u64>::with_capacity(1 << 16);
+    for (mut i = 0u; i < (1u << 16); ++i) {
+        mut key = FixedStr<32>();
+        sformat(key, "key_{}", i);
+        let h = hash(str(key));
+        lo.insert(h & 0xFFFFFFFF);
+        hi.insert(h >> 32);
+    }
+    assert_eq(lo.len() > 65500, true);
+    assert_eq(hi.len() > 65500, true);
+}
+
+unittest(hash_perf) {
+    let len = 1u << 20;
+    mut buf = List<char>::with_capacity(len);
+    for (mut i = 0u; i < len; ++i) {
+        buf.push(char(i * 31));
+    }
+
+    mut acc = u64(0);
+    let t0  = time::Instant::now();
+    for (mut k = 0u; k < 64; ++k) {
+        acc ^= hash(str(buf), k);
+    }
+    let t1 = time::Instant::now();
+
+    mut acc_short = u64(0);
+    for (mut k = 0u; k < (1u << 20); ++k) {
+        acc_short ^= hash(str(buf._data + (k & 1023), 24));
+    }
+    let t2 = time::Instant::now();
+
+    log::info("ustd::hash: {} MB/s on 1MB, {}ns per 24 byte key ({})",
+        u64(64.0 / (t1 - t0).total_secs()), (t2 - t1).total_nanos() >> 20, acc ^ acc_short);
+}
+
+}
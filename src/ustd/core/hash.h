@@ -0,0 +1,137 @@
+#pragma once
+
+#include "ustd/core/str.h"
+
+namespace ustd
+{
+
+// hash_mix: 64 bit finalizer (murmur3 fmix64), every input bit reaches every output bit
+constexpr fn hash_mix(u64 x) noexcept -> u64 {
+    x ^= x >> 33;
+    x *= 0xFF51AFD7ED558CCDull;
+    x ^= x >> 33;
+    x *= 0xC4CEB9FE1A85EC53ull;
+    x ^= x >> 33;
+    return x;
+}
+
+#pragma region wyhash
+constexpr static u64 $wy_secret[4] = {
+    0x2D358DCCAA6C78A5ull, 0x8BB84B93962EACC9ull, 0x4B33A62ED433D4A3ull, 0x4D5A2DA51DE1AA47ull,
+};
+
+// 64x64 -> 128 bit multiply, folded
+constexpr fn _wy_mix(u64 a, u64 b) noexcept -> u64 {
+    let r = static_cast<unsigned __int128>(a) * b;
+    return u64(r) ^ u64(r >> 64);
+}
+
+// little endian loads, byte by byte in constant evaluation
+constexpr fn _wy_read8(const char* p) noexcept -> u64 {
+    if (!__builtin_is_constant_evaluated()) {
+        mut res = u64(0);
+        __builtin_memcpy(&res, p, 8);
+        return res;
+    }
+    mut res = u64(0);
+    for (mut i = 0u; i < 8; ++i) {
+        res |= u64(u8(p[i])) << (8 * i);
+    }
+    return res;
+}
+
+constexpr fn _wy_read4(const char* p) noexcept -> u64 {
+    if (!__builtin_is_constant_evaluated()) {
+        mut res = u32(0);
+        __builtin_memcpy(&res, p, 4);
+        return res;
+    }
+    mut res = u64(0);
+    for (mut i = 0u; i < 4; ++i) {
+        res |= u64(u8(p[i])) << (8 * i);
+    }
+    return res;
+}
+#pragma endregion
+
+// hash: 64 bit wyhash of `s`, 48 bytes per step in three independent lanes
+//  - constexpr, `constexpr let h = hash("name");` is folded at compile time
+//  - `seed` changes every hash value, containers use a random one per process, see `hash_seed`
+constexpr fn hash(str s, u64 seed = 0) noexcept -> u64 {
+    let len = u64(s._size);
+    mut p   = s._data;
+    mut a   = u64(0);
+    mut b   = u64(0);
+
+    seed ^= _wy_mix(seed ^ $wy_secret[0], $wy_secret[1]);
+
+    if (len <= 16) {
+        if (len >= 4) {
+            let k = (len >> 3) << 2;
+            a = (_wy_read4(p) << 32) | _wy_read4(p + k);
+            b = (_wy_read4(p + len - 4) << 32) | _wy_read4(p + len - 4 - k);
+        }
+        else if (len > 0) {
+            a = (u64(u8(p[0])) << 16) | (u64(u8(p[len >> 1])) << 8) | u64(u8(p[len - 1]));
+        }
+    }
+    else {
+        mut i = len;
+        if (i >= 48) {
+            mut see1 = seed;
+            mut see2 = seed;
+            do {
+                seed = _wy_mix(_wy_read8(p)      ^ $wy_secret[1], _wy_read8(p + 8)  ^ seed);
+                see1 = _wy_mix(_wy_read8(p + 16) ^ $wy_secret[2], _wy_read8(p + 24) ^ see1);
+                see2 = _wy_mix(_wy_read8(p + 32) ^ $wy_secret[3], _wy_read8(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i >= 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16) {
+            seed = _wy_mix(_wy_read8(p) ^ $wy_secret[1], _wy_read8(p + 8) ^ seed);
+            p += 16;
+            i -= 16;
+        }
+        a = _wy_read8(p + i - 16);
+        b = _wy_read8(p + i - 8);
+    }
+
+    a ^= $wy_secret[1];
+    b ^= seed;
+    let r = static_cast<unsigned __int128>(a) * b;
+    return _wy_mix(u64(r) ^ $wy_secret[0] ^ len, u64(r >> 64) ^ $wy_secret[1]);
+}
+
+// hash_seed: random per process, fixed with the environment variable USTD_HASH_SEED
+pub fn hash_seed() noexcept -> u64;
+
+// Hash: hasher of HashMap and HashSet keys
+//  - keys that compare equal hash equal: String, StrView and str hash alike, so String keys are found by str
+//  - strings are hashed with a per process seed, so colliding keys can not be prepared offline
+template<class T, class = void>
+struct Hash;
+
+template<class T>
+struct Hash<T, when<trait<T>::$int || trait<T>::$enum || trait<T>::$ptr>>
+{
+    fn operator()(T val) const noexcept -> u64 {
+        return hash_mix(u64(val));
+    }
+};
+
+template<>
+struct Hash<str>
+{
+    u64 _seed = hash_seed();
+
+    fn operator()(str s) const noexcept -> u64 {
+        return hash(s, _seed);
+    }
+};
+
+template<> struct Hash<StrView> : Hash<str> {};
+template<> struct Hash<String>  : Hash<str> {};
+
+}
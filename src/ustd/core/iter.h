@@ -12,7 +12,7 @@ template<typename T>
 struct Iter
 {
     using type_t = T;
-    using size_t = u32;
+    using size_t = usize;
 
     type_t* _data;
     size_t  _size;
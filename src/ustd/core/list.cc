@@ -42,4 +42,56 @@ unittest(Heap){
     }
 }
 
+unittest(List_grow) {
+    static_assert(trivially_relocatable<u32>::$value);
+    static_assert(trivially_relocatable<List<u32>>::$value);
+    static_assert(!trivially_relocatable<FixedList<u32, 4>>::$value);
+
+    mut v = List<List<u32>>::with_capacity(1);
+    for (mut i = 0u; i < 100; ++i) {
+        mut item = List<u32>::with_capacity(1);
+        item.push(i);
+        v.push(as_mov(item));
+    }
+    for (mut i = 0u; i < 100; ++i) {
+        assert_eq(v[i][0], i);
+    }
+
+    // the latest arena block grows in place
+    mut arena = Arena();
+    {
+        let scope = Arena::Scope(arena);
+        mut s = List<u8>::with_capacity(16);
+        let p = s._data;
+        s.reserve(1024);
+        assert_eq(s._data == p, true);
+    }
+
+    // large blocks are remapped, the content moves with them
+    mut big = List<u32>::with_capacity(1u << 20);
+    for (mut i = 0u; i < (1u << 20); ++i) {
+        big.push(i);
+    }
+    big.reserve(4u << 20);
+    assert_eq(big._capacity, usize(4u << 20));
+    for (mut i = 0u; i < (1u << 20); ++i) {
+        assert_eq(big[i], i);
+    }
+    big.push(1u << 20);
+    assert_eq(big[1u << 20], 1u << 20);
+}
+
+unittest(List_size) {
+    static_assert(sizeof(usize) == (USTD_SIZE64 ? 8 : 4));
+    static_assert(sizeof(Slice<u8>) == sizeof(void*) + 2 * sizeof(usize));
+
+    mut v = List<u8>::with_capacity(16);
+    v.pushn(10, u8(1));
+    v.push(u8(2));
+    assert_eq(v.len(), usize(11));
+    assert_eq(v.find(u8(2)), Option<usize>::Some(10));
+    assert_eq(v.slice(usize(2), usize(5)).len(), usize(4));
+    assert_eq(v.slice(-3, -1).len(), usize(3));
+}
+
 }
@@ -3,6 +3,7 @@
 #include "ustd/core/slice.h"
 #include "ustd/core/mem.h"
 #include "ustd/core/ops.h"
+#include "ustd/core/panic.h"
 
 namespace ustd
 {
@@ -23,6 +24,9 @@ class List : public Slice<T>
 public:
     using base   = Slice<T>;
 
+    // a List owns a heap block only, so it may be moved with memcpy
+    constexpr static let $relocatable = true;
+
 #pragma region ctor/dtor
     // ctor: default
     List() noexcept: base{}
@@ -39,7 +43,7 @@ public:
         if (base::_data == nullptr) return;
 
         if constexpr (!trivial<T>::$dtor) {
-            for(mut i = 0u; i < base::_size; ++i) {
+            for(mut i = usize(0); i < base::_size; ++i) {
                 mut& t = base::_data[i];
                 t.~T();
             }
@@ -49,32 +53,48 @@ public:
     }
 
     // ctor: with_capacity
-    static fn with_capacity(u32 capacity) noexcept -> List {
+    static fn with_capacity(usize capacity) noexcept -> List {
         let data = mnew<T>(capacity);
-        return List{ data, 0u, capacity };
+        return List{ data, 0, capacity };
    }
 #pragma endregion
 
 #pragma region methods
-    fn reserve(u32 new_capacity) noexcept {
+    fn reserve(usize new_capacity) noexcept {
         let old_capacity = base::_capacity;
         if (new_capacity <= old_capacity) {
             return;
         }
 
+        // grow the block in place, or let realloc/mremap move it
+        if constexpr (trivially_relocatable<T>::$value) {
+            if (base::_data != nullptr) {
+                let new_data = mrenew(base::_data, base::_size, new_capacity);
+                if (new_data == nullptr) {
+                    ustd::panic("ustd::List<...>.reserve: out of memory.");
+                }
+                base::_data     = new_data;
+                base::_capacity = new_capacity;
+                return;
+            }
+        }
+
         let old_data = base::_data;
         let new_data = mnew<T>(new_capacity);
-        mmov(old_data, new_data, base::_size);
+        if (new_data == nullptr) {
+            ustd::panic("ustd::List<...>.reserve: out of memory.");
+        }
+        mmov(new_data, old_data, base::_size);
 
         mdel(old_data);
         base::_data     = new_data;
         base::_capacity = new_capacity;
     }
 
-    fn grow(u32 count) noexcept {
+    fn grow(usize count) noexcept {
         let old_capacity = base::_capacity;
         let min_capacity = old_capacity + count;
-        let max_capacity = (old_capacity + old_capacity / 4 + 63) & (~63u);
+        let max_capacity = (old_capacity + old_capacity / 4 + 63) & ~usize(63);
         let new_capacity = ustd::max(min_capacity, max_capacity);
         reserve(new_capacity);
     }
@@ -93,7 +113,7 @@ public:
 
     // method: push
     template<class ...U>
-    fn pushn(u32 n, U&& ...u) noexcept -> Option<List&> {
+    fn pushn(usize n, U&& ...u) noexcept -> Option<List&> {
         if (base::_size + n > base::_capacity) {
             grow(n);
         }
@@ -142,7 +162,7 @@ public:
 
 protected:
     // ctor:
-    List(T* data, u32 length, u32 capacity) noexcept
+    List(T* data, usize length, usize capacity) noexcept
         : base(data, length, capacity)
     {}
 };
@@ -153,6 +173,9 @@ class FixedList: public List<T>
 public:
     using base = List<T>;
 
+    // `_data` points into the object
+    constexpr static let $relocatable = false;
+
     union
     {
         u8  _nul;
@@ -208,8 +231,8 @@ template<class T, class List = List<T> >
 class Deque {
 public:
     List    _list;
-    u32     _head;
-    u32     _tail;
+    usize   _head;
+    usize   _tail;
 
     enum class Opt {
         None,
@@ -232,7 +255,7 @@ public:
     }
 
 #pragma region property
-    fn capacity() const noexcept  -> u32 {
+    fn capacity() const noexcept  -> usize {
         return _list.capacity();
     }
 
@@ -397,7 +420,7 @@ public:
         return base::is_full();
     }
 
-    fn capacity() const noexcept  -> u32 {
+    fn capacity() const noexcept  -> usize {
         return base::get_capacity();
     }
 
@@ -477,7 +500,7 @@ public:
     }
 
     // property[r]: capacity
-    fn capacity() const noexcept  -> u32 {
+    fn capacity() const noexcept  -> usize {
         return base::capacity();
     }
 
@@ -564,7 +587,7 @@ private:
     Heap(U&& ...u) noexcept : _list(as_fwd<U>(u)...) {
     }
 
-    fn shift_up(u32 inode) noexcept {
+    fn shift_up(usize inode) noexcept {
         while (inode > 0) {
             let iroot = (inode - 1) / 2;
             if (_list[iroot] <= _list[inode]) break;
@@ -574,7 +597,7 @@ private:
         }
     }
 
-    fn shift_down(u32 inode) noexcept {
+    fn shift_down(usize inode) noexcept {
         let cnt = _list._size;
 
         while (inode * 2 + 1 < cnt) {
@@ -0,0 +1,184 @@
+#include "config.inl"
+
+namespace ustd
+{
+
+static fn key_str(u32 idx) noexcept -> String {
+    mut buf = FixedStr<32>();
+    sformat(buf, "key_{}", idx);
+
+    mut res = String::with_capacity(buf._size);
+    res.push_slice(str(buf));
+    return res;
+}
+
+// values alive, counted by ctor and dtor
+static mut probe_live = i32(0);
+
+struct Probe
+{
+    u32 _val;
+
+    explicit Probe(u32 val) noexcept : _val(val) { ++probe_live; }
+    Probe(Probe&& other) noexcept : _val(other._val) { ++probe_live; }
+    ~Probe() noexcept { --probe_live; }
+};
+
+unittest(HashMap) {
+    mut m = HashMap<u32, u32>();
+    assert_eq(m.get(1u).is_none(), true);
+
+    for (mut i = 0u; i < 10000; ++i) {
+        m.insert(i, i * 2);
+    }
+    assert_eq(m.len(), usize(10000));
+    for (mut i = 0u; i < 10000; ++i) {
+        assert_eq(m.get(i)._val, i * 2);
+    }
+
+    // overwrite
+    assert_eq(m.insert(7u, 1u), Option<u32>::Some(14u));
+    assert_eq(m.get(7u)._val, 1u);
+
+    // remove every other key, the rest stays reachable
+    for (mut i = 0u; i < 10000; i += 2) {
+        assert_eq(m.remove(i).is_some(), true);
+    }
+    assert_eq(m.len(), usize(5000));
+    for (mut i = 0u; i < 10000; ++i) {
+        assert_eq(m.contains(i), i % 2 == 1);
+    }
+
+    // tombstones are reused
+    let cap = m.capacity();
+    for (mut k = 0u; k < 100; ++k) {
+        m.insert(20000u + k, k);
+        m.remove(20000u + k);
+    }
+    assert_eq(m.capacity(), cap);
+
+    mut sum = u64(0);
+    for (let& e : m.into_iter()) {
+        sum += e._key;
+    }
+    assert_eq(sum, u64(25000000));
+
+    m.rehash();
+    assert_eq(m.len(), usize(5000));
+    assert_eq(m.get(9999u)._val, 19998u);
+
+    m.clear();
+    assert_eq(m.is_empty(), true);
+    assert_eq(m.contains(1u), false);
+}
+
+unittest(HashMap_str) {
+    mut m = HashMap<String, u32>::with_capacity(100);
+    for (mut i = 0u; i < 100; ++i) {
+        m.insert(key_str(i), i);
+    }
+
+    // heterogeneous lookup, no String is built
+    assert_eq(m.get(str("key_42"))._val, 42u);
+    assert_eq(m.get("key_99")._val, 99u);
+    assert_eq(m.contains("key_100"), false);
+    assert_eq(m.remove("key_5"), Option<u32>::Some(5u));
+    assert_eq(m.len(), usize(99));
+}
+
+unittest(HashMap_overwrite) {
+    {
+        mut m = HashMap<u32, Probe>();
+        m.insert(1u, Probe(1));
+        for (mut i = 2u; i < 10; ++i) {
+            let old = m.insert(1u, Probe(i));
+            assert_eq(old._val._val, i - 1);
+        }
+        assert_eq(m.get(1u)._val._val, 9u);
+    }
+
+    // the moved-out old values are dropped too
+    assert_eq(probe_live, 0);
+}
+
+unittest(HashSet) {
+    mut s = HashSet<u64>::with_capacity(16);
+    assert_eq(s.insert(u64(3)), true);
+    assert_eq(s.insert(u64(3)), false);
+    assert_eq(s.insert(u64(5)), true);
+    assert_eq(s.contains(u64(3)), true);
+    assert_eq(s.remove(u64(3)), true);
+    assert_eq(s.remove(u64(3)), false);
+    assert_eq(s.len(), usize(1));
+
+    mut cnt = 0u;
+    for (let& k : s.into_iter()) {
+        assert_eq(k, u64(5));
+        cnt += 1;
+    }
+    assert_eq(cnt, 1u);
+}
+
+unittest(HashMap_perf) {
+    const u32 sizes[] = { 16, 256, 4096, 65536 };
+    let lookups = 1u << 20;
+
+    for (let n : sizes) {
+        mut keys = List<u64>::with_capacity(n);
+        mut m    = HashMap<u64, u32>::with_capacity(n);
+        for (mut i = 0u; i < n; ++i) {
+            let key = hash_mix(i + 1);
+            keys.push(key);
+            m.insert(key, i);
+        }
+
+        mut heap = List<u64>::with_capacity(n).as_heap();
+        for (mut i = 0u; i < n; ++i) {
+            heap.push(keys[i]);
+        }
+        mut sorted = List<u64>::with_capacity(n);
+        for (mut i = 0u; i < n; ++i) {
+            sorted.push(heap.pop()._val);
+        }
+
+        // hash map
+        mut hit0 = u64(0);
+        let t0 = time::Instant::now();
+        for (mut k = 0u; k < lookups; ++k) {
+            hit0 += m.get(keys[u64(k) * 7919 % n])._val;
+        }
+        let t1 = time::Instant::now();
+
+        // sorted vector, binary search
+        mut hit1 = u64(0);
+        for (mut k = 0u; k < lookups; ++k) {
+            let key = keys[u64(k) * 7919 % n];
+            mut lo = 0u;
+            mut hi = n;
+            while (lo < hi) {
+                let mid = (lo + hi) / 2;
+                if (sorted[mid] < key) lo = mid + 1; else hi = mid;
+            }
+            hit1 += lo;
+        }
+        let t2 = time::Instant::now();
+
+        // linear search, fewer lookups on large sizes
+        let linear = n <= 4096 ? lookups / (n / 16) : 0u;
+        mut hit2 = u64(0);
+        for (mut k = 0u; k < linear; ++k) {
+            hit2 += keys.find(keys[u64(k) * 7919 % n])._val;
+        }
+        let t3 = time::Instant::now();
+
+        assert_eq(hit0 > 0, true);
+        (void)hit1;
+        (void)hit2;
+
+        log::info("ustd::HashMap[n={}]: hash={}ns, sorted={}ns, linear={}ns per lookup",
+            n, (t1 - t0).total_nanos() / lookups, (t2 - t1).total_nanos() / lookups,
+            linear == 0 ? u64(0) : (t3 - t2).total_nanos() / linear);
+    }
+}
+
+}
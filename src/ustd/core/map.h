@@ -0,0 +1,470 @@
+#pragma once
+
+#include "ustd/core/hash.h"
+#include "ustd/core/mem.h"
+
+namespace ustd
+{
+
+#pragma region group
+// HashGroup: $width control bytes, probed at once
+//  - a control byte is h2 (the low 7 bits of the hash) for a full slot, $empty or $deleted
+struct HashGroup
+{
+    constexpr static let $width   = 16u;
+    constexpr static let $empty   = i8(-128);
+    constexpr static let $deleted = i8(-2);
+
+    using raw_t  = i8   __attribute__((vector_size(16)));
+    using mask_t = char __attribute__((vector_size(16)));
+
+    raw_t _raw;
+
+    static fn load(const i8* ctrl) noexcept -> HashGroup {
+        mut res = HashGroup{};
+        __builtin_memcpy(&res._raw, ctrl, sizeof(raw_t));
+        return res;
+    }
+
+    // bit i: control byte i is `h2`
+    fn match(i8 h2) const noexcept -> u32 {
+        return _bitmask(_raw == (raw_t{} + h2));
+    }
+
+    // bit i: control byte i is $empty
+    fn match_empty() const noexcept -> u32 {
+        return _bitmask(_raw == (raw_t{} + $empty));
+    }
+
+    // bit i: control byte i is $empty or $deleted
+    fn match_free() const noexcept -> u32 {
+        return _bitmask(_raw < (raw_t{} + i8(-1)));
+    }
+
+    static fn _bitmask(raw_t cmp) noexcept -> u32 {
+#if defined(__SSE2__)
+        return u32(__builtin_ia32_pmovmskb128(__builtin_bit_cast(mask_t, cmp)));
+#else
+        mut res = 0u;
+        for (mut i = 0u; i < $width; ++i) {
+            res |= u32(cmp[i] != 0) << i;
+        }
+        return res;
+#endif
+    }
+};
+#pragma endregion
+
+#pragma region entry
+template<class K, class V>
+struct MapEntry
+{
+    K   _key;
+    V   _val;
+};
+
+template<class K, class V>
+fn _hash_key(const MapEntry<K, V>& entry) noexcept -> const K& {
+    return entry._key;
+}
+
+template<class K>
+fn _hash_key(const K& key) noexcept -> const K& {
+    return key;
+}
+
+// iter: full slots of a hash table, in slot order
+template<class E>
+struct HashIter
+{
+    using type_t = E;
+
+    const i8*   _ctrl;
+    E*          _slots;
+    usize       _capacity;
+    usize       _index;
+
+    fn next() noexcept -> Option<E&> {
+        while (_index < _capacity) {
+            let idx = _index++;
+            if (_ctrl[idx] >= 0) {
+                return Option<E&>::Some(_slots[idx]);
+            }
+        }
+        return Option<E&>::None();
+    }
+};
+#pragma endregion
+
+#pragma region table
+// HashTable: open addressing swiss table, the storage of HashMap and HashSet
+//  - a lookup loads $width control bytes at once, and compares keys only where h2 matches
+//  - groups are probed triangularly, at most 7/8 of the slots are used
+template<class E, class H>
+class HashTable
+{
+public:
+    constexpr static let $width = usize(HashGroup::$width);
+
+    i8*     _ctrl;          // _capacity + $width bytes, the last $width mirror the first
+    E*      _slots;
+    usize   _size;
+    usize   _capacity;      // 0, or a power of 2 >= $width
+    usize   _growth_left;   // inserts into $empty slots before the next rehash
+    H       _hasher;
+
+#pragma region ctor/dtor
+    HashTable() noexcept
+        : _ctrl(nullptr), _slots(nullptr), _size(0), _capacity(0), _growth_left(0), _hasher()
+    {}
+
+    HashTable(HashTable&& other) noexcept
+        : _ctrl(other._ctrl), _slots(other._slots), _size(other._size), _capacity(other._capacity)
+        , _growth_left(other._growth_left), _hasher(other._hasher)
+    {
+        other._ctrl        = nullptr;
+        other._slots       = nullptr;
+        other._size        = 0;
+        other._capacity    = 0;
+        other._growth_left = 0;
+    }
+
+    ~HashTable() noexcept {
+        _drop();
+    }
+#pragma endregion
+
+#pragma region property
+    fn len() const noexcept -> usize {
+        return _size;
+    }
+
+    fn capacity() const noexcept -> usize {
+        return _capacity;
+    }
+
+    fn is_empty() const noexcept -> bool {
+        return _size == 0;
+    }
+#pragma endregion
+
+#pragma region method
+    // method: drop every entry, keep the memory
+    fn clear() noexcept -> void {
+        if (_capacity == 0) {
+            return;
+        }
+        _drop_slots();
+        ustd_builtin(memset)(_ctrl, u8(HashGroup::$empty), _capacity + $width);
+        _size        = 0;
+        _growth_left = _max_load(_capacity);
+    }
+
+    // method: room for `cnt` entries without a rehash
+    fn reserve(usize cnt) noexcept -> void {
+        if (cnt <= _size + _growth_left) {
+            return;
+        }
+        _resize(_capacity_for(cnt));
+    }
+
+    // method: rebuild for max(`cnt`, len()) entries, drops $deleted slots, may shrink
+    fn rehash(usize cnt = 0) noexcept -> void {
+        let need = ustd::max(cnt, _size);
+        if (need == 0) {
+            _drop();
+            _ctrl        = nullptr;
+            _slots       = nullptr;
+            _capacity    = 0;
+            _growth_left = 0;
+            return;
+        }
+        _resize(_capacity_for(need));
+    }
+#pragma endregion
+
+protected:
+    static fn _max_load(usize cap) noexcept -> usize {
+        return cap - cap / 8;
+    }
+
+    static fn _capacity_for(usize cnt) noexcept -> usize {
+        mut cap = usize($width);
+        while (_max_load(cap) < cnt) {
+            cap *= 2;
+        }
+        return cap;
+    }
+
+    static fn _h1(u64 hash) noexcept -> usize {
+        return usize(hash >> 7);
+    }
+
+    static fn _h2(u64 hash) noexcept -> i8 {
+        return i8(hash & 0x7F);
+    }
+
+    fn _set_ctrl(usize idx, i8 val) noexcept -> void {
+        _ctrl[idx] = val;
+        _ctrl[((idx - $width) & (_capacity - 1)) + $width] = val;
+    }
+
+    // slot of `key`, nullptr when missing
+    template<class Q>
+    fn _find(const Q& key, u64 hash) const noexcept -> E* {
+        if (_capacity == 0) {
+            return nullptr;
+        }
+
+        let mask = _capacity - 1;
+        let h2   = _h2(hash);
+        mut pos  = _h1(hash) & mask;
+        mut step = usize(0);
+        while (true) {
+            let group = HashGroup::load(_ctrl + pos);
+            for (mut bits = group.match(h2); bits != 0; bits &= bits - 1) {
+                let idx = (pos + usize(__builtin_ctz(bits))) & mask;
+                if (_hash_key(_slots[idx]) == key) {
+                    return &_slots[idx];
+                }
+            }
+            if (group.match_empty() != 0) {
+                return nullptr;
+            }
+            step += $width;
+            pos   = (pos + step) & mask;
+        }
+    }
+
+    // first $empty or $deleted slot on the probe sequence of `hash`
+    fn _find_free(u64 hash) const noexcept -> usize {
+        let mask = _capacity - 1;
+        mut pos  = _h1(hash) & mask;
+        mut step = usize(0);
+        while (true) {
+            let bits = HashGroup::load(_ctrl + pos).match_free();
+            if (bits != 0) {
+                return (pos + usize(__builtin_ctz(bits))) & mask;
+            }
+            step += $width;
+            pos   = (pos + step) & mask;
+        }
+    }
+
+    // slot for a new entry of `hash`, its control byte is set, the entry is not constructed
+    fn _prepare_insert(u64 hash) noexcept -> usize {
+        if (_capacity == 0) {
+            _resize($width);
+        }
+
+        mut idx = _find_free(hash);
+        if (_growth_left == 0 && _ctrl[idx] == HashGroup::$empty) {
+            // many tombstones: clean up in place, else grow
+            _resize(_size < _capacity * 7 / 16 ? _capacity : _capacity * 2);
+            idx = _find_free(hash);
+        }
+
+        if (_ctrl[idx] == HashGroup::$empty) {
+            _growth_left -= 1;
+        }
+        _set_ctrl(idx, _h2(hash));
+        _size += 1;
+        return idx;
+    }
+
+    // the entry at `slot` is destroyed already
+    fn _erase(E* slot) noexcept -> void {
+        let idx  = usize(slot - _slots);
+        let mask = _capacity - 1;
+
+        // $empty only if no probe window ever saw the group full around `idx`
+        let before = HashGroup::load(_ctrl + ((idx - $width) & mask)).match_empty();
+        let after  = HashGroup::load(_ctrl + idx).match_empty();
+        let empty  = before != 0 && after != 0 && u32(__builtin_ctz(after)) + u32(__builtin_clz(before) - 16) < $width;
+
+        _set_ctrl(idx, empty ? HashGroup::$empty : HashGroup::$deleted);
+        _size -= 1;
+        if (empty) {
+            _growth_left += 1;
+        }
+    }
+
+    fn _resize(usize new_capacity) noexcept -> void {
+        let old_ctrl  = _ctrl;
+        let old_slots = _slots;
+        let old_cap   = _capacity;
+
+        _ctrl        = mnew<i8>(new_capacity + $width);
+        _slots       = mnew<E>(new_capacity);
+        _capacity    = new_capacity;
+        _growth_left = _max_load(new_capacity) - _size;
+        ustd_builtin(memset)(_ctrl, u8(HashGroup::$empty), new_capacity + $width);
+
+        for (mut i = usize(0); i < old_cap; ++i) {
+            if (old_ctrl[i] < 0) continue;
+
+            let hash = u64(_hasher(_hash_key(old_slots[i])));
+            let idx  = _find_free(hash);
+            _set_ctrl(idx, _h2(hash));
+            ustd::ctor(&_slots[idx], as_mov(old_slots[i]));
+            ustd::dtor(&old_slots[i]);
+        }
+
+        mdel(old_ctrl);
+        mdel(old_slots);
+    }
+
+    fn _drop_slots() noexcept -> void {
+        if constexpr (!trivial<E>::$dtor) {
+            for (mut i = usize(0); i < _capacity; ++i) {
+                if (_ctrl[i] >= 0) {
+                    ustd::dtor(&_slots[i]);
+                }
+            }
+        }
+    }
+
+    fn _drop() noexcept -> void {
+        if (_capacity == 0) {
+            return;
+        }
+        _drop_slots();
+        mdel(_ctrl);
+        mdel(_slots);
+    }
+};
+#pragma endregion
+
+#pragma region map
+template<class K, class V, class H = Hash<K>>
+class HashMap : public HashTable<MapEntry<K, V>, H>
+{
+public:
+    using base  = HashTable<MapEntry<K, V>, H>;
+    using Entry = MapEntry<K, V>;
+
+    HashMap() noexcept = default;
+    HashMap(HashMap&& other) noexcept = default;
+
+    // ctor: with_capacity
+    static fn with_capacity(usize cnt) noexcept -> HashMap {
+        mut res = HashMap();
+        res.reserve(cnt);
+        return res;
+    }
+
+    // method: get, `key` may be any type H hashes and K compares with, a str for String keys
+    template<class Q>
+    fn get(const Q& key) noexcept -> Option<V&> {
+        mut entry = base::_find(key, u64(base::_hasher(key)));
+        return entry == nullptr ? Option<V&>::None() : Option<V&>::Some(entry->_val);
+    }
+
+    template<class Q>
+    fn get(const Q& key) const noexcept -> Option<const V&> {
+        let entry = base::_find(key, u64(base::_hasher(key)));
+        return entry == nullptr ? Option<const V&>::None() : Option<const V&>::Some(entry->_val);
+    }
+
+    template<class Q>
+    fn contains(const Q& key) const noexcept -> bool {
+        return base::_find(key, u64(base::_hasher(key))) != nullptr;
+    }
+
+    // method: insert, the previous value of `key` if any
+    fn insert(K key, V val) noexcept -> Option<V> {
+        let hash  = u64(base::_hasher(key));
+        mut entry = base::_find(key, hash);
+        if (entry != nullptr) {
+            mut res = Option<V>::Some(as_mov(entry->_val));
+            ustd::dtor(&entry->_val);
+            ustd::ctor(&entry->_val, as_mov(val));
+            return res;
+        }
+
+        let idx = base::_prepare_insert(hash);
+        mut& slot = base::_slots[idx];
+        ustd::ctor(&slot._key, as_mov(key));
+        ustd::ctor(&slot._val, as_mov(val));
+        return Option<V>::None();
+    }
+
+    // method: remove, the value of `key` if any
+    template<class Q>
+    fn remove(const Q& key) noexcept -> Option<V> {
+        mut entry = base::_find(key, u64(base::_hasher(key)));
+        if (entry == nullptr) {
+            return Option<V>::None();
+        }
+
+        mut res = Option<V>::Some(as_mov(entry->_val));
+        ustd::dtor(entry);
+        base::_erase(entry);
+        return res;
+    }
+
+    // iter: entries, keys must not be changed
+    fn into_iter() noexcept -> HashIter<Entry> {
+        return { base::_ctrl, base::_slots, base::_capacity, 0 };
+    }
+
+    fn into_iter() const noexcept -> HashIter<const Entry> {
+        return { base::_ctrl, base::_slots, base::_capacity, 0 };
+    }
+};
+#pragma endregion
+
+#pragma region set
+template<class K, class H = Hash<K>>
+class HashSet : public HashTable<K, H>
+{
+public:
+    using base = HashTable<K, H>;
+
+    HashSet() noexcept = default;
+    HashSet(HashSet&& other) noexcept = default;
+
+    // ctor: with_capacity
+    static fn with_capacity(usize cnt) noexcept -> HashSet {
+        mut res = HashSet();
+        res.reserve(cnt);
+        return res;
+    }
+
+    template<class Q>
+    fn contains(const Q& key) const noexcept -> bool {
+        return base::_find(key, u64(base::_hasher(key))) != nullptr;
+    }
+
+    // method: insert, false when `key` is in already
+    fn insert(K key) noexcept -> bool {
+        let hash = u64(base::_hasher(key));
+        if (base::_find(key, hash) != nullptr) {
+            return false;
+        }
+
+        let idx = base::_prepare_insert(hash);
+        ustd::ctor(&base::_slots[idx], as_mov(key));
+        return true;
+    }
+
+    // method: remove, false when `key` is missing
+    template<class Q>
+    fn remove(const Q& key) noexcept -> bool {
+        mut slot = base::_find(key, u64(base::_hasher(key)));
+        if (slot == nullptr) {
+            return false;
+        }
+
+        ustd::dtor(slot);
+        base::_erase(slot);
+        return true;
+    }
+
+    fn into_iter() const noexcept -> HashIter<const K> {
+        return { base::_ctrl, base::_slots, base::_capacity, 0 };
+    }
+};
+#pragma endregion
+
+}
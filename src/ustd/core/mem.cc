@@ -8,65 +8,462 @@ fn __builtin_operator_delete(void* ptr)   -> void;
 namespace ustd
 {
 
-static fn make_dims_list(u32 rank, const u64 dims[]) -> FixedList<u64, 8> {
-    mut dims_list = FixedList<u64, 8>();
+static fn get_total_cnt(u32 rank, const u64 dims[]) -> u64 {
+    mut total_cnt = u64(1);
 
     for (mut i = 0u; i < rank; ++i) {
-        dims_list.push(dims[i]);
+        total_cnt *= dims[i];
     }
 
-    return dims_list;
+    return total_cnt;
 }
 
-static fn get_total_cnt(u32 rank, const u64 dims[]) -> u64 {
-    mut total_cnt = u64(1);
+#pragma region stats
+#if USTD_MEM_STATS
+// every block is prefixed with its size, so `_mdel` knows what goes away
+static constexpr let $stats_header = u64(16);
 
-    for (mut i = 0u; i < rank; ++i) {
-        total_cnt *= dims[i];
+struct MemTypeSlot
+{
+    const char*     _key;       // Type::_desc, atomic
+    MemTypeStats    _stats;
+};
+
+static mut _stats       = MemStats{};
+static mut _type_slots  = static_cast<MemTypeSlot*>(nullptr);
+
+static fn stats_bin(u64 size) noexcept -> u32 {
+    let bin = size == 0 ? 0u : 64u - u32(__builtin_clzll(size));
+    return ustd::min(bin, MemStats::$bins - 1);
+}
+
+static fn stats_slots() noexcept -> MemTypeSlot* {
+    // raw operator new: not counted, never freed
+    static let slots = [] {
+        let bytes = sizeof(MemTypeSlot) * MemStats::$max_types;
+        mut res   = static_cast<MemTypeSlot*>(::__builtin_operator_new(bytes));
+        ustd_builtin(memset)(res, 0, bytes);
+        ::atexit([] { mem_stats_dump(); });
+        return res;
+    }();
+    return slots;
+}
+
+// slot of `type`, keyed by the address of its desc, nullptr when the table is full
+static fn stats_slot(const Type& type) noexcept -> MemTypeStats* {
+    let slots = stats_slots();
+    let key   = type._desc._data;
+    let hash  = u32((u64(key) >> 4) * 0x9E3779B97F4A7C15ull >> 56);
+
+    for (mut i = 0u; i < MemStats::$max_types; ++i) {
+        mut& slot = slots[(hash + i) % MemStats::$max_types];
+        let  cur  = sync::load(&slot._key, sync::Ordering::Acquire);
+        if (cur == key) {
+            return &slot._stats;
+        }
+        if (cur == nullptr && sync::compare_exchange(&slot._key, static_cast<const char*>(nullptr), key)) {
+            slot._stats._type = type;
+            return &slot._stats;
+        }
+        if (sync::load(&slot._key, sync::Ordering::Acquire) == key) {
+            return &slot._stats;
+        }
     }
+    return nullptr;
+}
 
-    return total_cnt;
+static fn stats_alloc(const Type& type, u64 size) noexcept -> void {
+    sync::fetch_and_add(&_stats._alloc_cnt, u64(1));
+    sync::fetch_and_add(&_stats._alloc_bytes, size);
+    sync::fetch_and_add(&_stats._bins[stats_bin(size)], u64(1));
+
+    let live = sync::fetch_and_add(&_stats._live_bytes, size) + size;
+    mut peak = sync::load(&_stats._peak_bytes, sync::Ordering::Relaxed);
+    while (live > peak && !sync::compare_exchange(&_stats._peak_bytes, peak, live)) {
+        peak = sync::load(&_stats._peak_bytes, sync::Ordering::Relaxed);
+    }
+
+    mut slot = stats_slot(type);
+    if (slot != nullptr) {
+        sync::fetch_and_add(&slot->_alloc_cnt, u64(1));
+        sync::fetch_and_add(&slot->_alloc_bytes, size);
+    }
+}
+
+static fn stats_free(const Type& type, u64 size) noexcept -> void {
+    sync::fetch_and_add(&_stats._free_cnt, u64(1));
+    sync::fetch_and_add(&_stats._free_bytes, size);
+    sync::fetch_and_sub(&_stats._live_bytes, size);
+
+    mut slot = stats_slot(type);
+    if (slot != nullptr) {
+        sync::fetch_and_add(&slot->_free_cnt, u64(1));
+        sync::fetch_and_add(&slot->_free_bytes, size);
+    }
+}
+#endif
+#pragma endregion
+
+#pragma region alloc
+static mut _backend = u32(MemBackend::System);
+
+pub fn set_mem_backend(MemBackend backend) noexcept -> void {
+    sync::store(&_backend, u32(backend), sync::Ordering::Relaxed);
+}
+
+pub fn get_mem_backend() noexcept -> MemBackend {
+    return MemBackend(sync::load(&_backend, sync::Ordering::Relaxed));
+}
+
+static fn raw_new(u64 size) noexcept -> void* {
+    mut arena = Arena::current();
+    if (arena != nullptr) {
+        return arena->alloc(size);
+    }
+
+    if (size <= slab::$max_size && get_mem_backend() == MemBackend::Slab) {
+        let res = slab::alloc(size);
+        if (res != nullptr) {
+            return res;
+        }
+    }
+
+    // the C heap, so blocks can grow with realloc
+    return ::malloc(size);
+}
+
+static fn raw_del(void* raw) noexcept -> void {
+    // arena blocks are found by the page map, whatever scope is open
+    mut arena = Arena::owner(raw);
+    if (arena != nullptr) {
+        arena->free(raw);
+        return;
+    }
+    if (slab::free(raw)) {
+        return;
+    }
+    ::free(raw);
+}
+
+// new block, `keep` bytes copied, old block dropped
+static fn raw_move(void* raw, u64 keep, u64 size) noexcept -> void* {
+    mut res = raw_new(size);
+    if (res == nullptr) {
+        return nullptr;
+    }
+    ustd_builtin(memcpy)(res, raw, ustd::min(keep, size));
+    raw_del(raw);
+    return res;
+}
+
+static fn raw_renew(void* raw, u64 keep, u64 size) noexcept -> void* {
+    mut arena = Arena::owner(raw);
+    if (arena != nullptr) {
+        return arena->resize(raw, size) ? raw : raw_move(raw, keep, size);
+    }
+
+    let slab_size = slab::block_size(raw);
+    if (slab_size != 0) {
+        return size <= slab_size ? raw : raw_move(raw, keep, size);
+    }
+
+    // large blocks of glibc are mappings, realloc moves them with mremap
+    return ::realloc(raw, size);
 }
 
 pub fn _mnew(Type type, u32 rank, const u64 dims[]) noexcept -> void* {
-    let dims_list = make_dims_list(rank, dims);
     let total_cnt = get_total_cnt(rank, dims);
+    if (total_cnt == 0) {
+        return nullptr;
+    }
 
-    mut res = static_cast<void*>(nullptr);
+    let size = type._size * total_cnt;
 
-    try {
-        if (total_cnt != 0) {
-            res = ::__builtin_operator_new(type._size*total_cnt);
-        }
-        log::trace("ustd::mem::mnew<{}>(dims={}) -> Ok({})", type, dims_list, res);
+#if USTD_MEM_STATS
+    mut raw = static_cast<u8*>(raw_new(size + $stats_header));
+    if (raw == nullptr) {
+        log::error("ustd::mem::mnew<{}>(size={}) -> Error(`out of memory`)", type, size);
+        return nullptr;
+    }
+    *reinterpret_cast<u64*>(raw) = size;
+    stats_alloc(type, size);
+    return raw + $stats_header;
+#else
+    let res = raw_new(size);
+    if (res == nullptr) {
+        log::error("ustd::mem::mnew<{}>(size={}) -> Error(`out of memory`)", type, size);
     }
-    catch(...) {
-        log::trace("ustd::mem::mnew<{}>(dims={}) -> Error()", type, dims_list);
+    return res;
+#endif
+}
+
+pub fn _mdel(Type type, void* ptr) noexcept -> void {
+    if (ptr == nullptr) {
+        return;
     }
 
+#if USTD_MEM_STATS
+    mut raw = static_cast<u8*>(ptr) - $stats_header;
+    stats_free(type, *reinterpret_cast<u64*>(raw));
+    raw_del(raw);
+#else
+    (void)type;
+    raw_del(ptr);
+#endif
+}
+
+// header in front of an aligned block
+struct AlignedHeader
+{
+    void*   _raw;       // block of raw_new, or the mapping
+    u64     _map;       // bytes mapped, 0 for raw_new blocks
+    u64     _size;
+};
+
+static constexpr let $aligned_header = u64(32);
+
+static fn map_huge(u64 size, u64 align, AlignedHeader& head) noexcept -> u8* {
+#if defined(MADV_HUGEPAGE)
+    // one more huge page, so the block starts on a huge page boundary after the header
+    let page = ustd::max(align, $mem_huge_page);
+    let map  = (size + page - 1) / page * page + page;
+
+    let raw = ::mmap(nullptr, map, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) {
+        return nullptr;
+    }
+
+    let res = reinterpret_cast<u8*>((u64(raw) + $aligned_header + page - 1) & ~(page - 1));
+    ::madvise(res, map - u64(res - static_cast<u8*>(raw)), MADV_HUGEPAGE);
+
+    head._raw = raw;
+    head._map = map;
     return res;
+#else
+    (void)size; (void)align; (void)head;
+    return nullptr;
+#endif
 }
 
-pub fn _mdel(Type type, void* raw) noexcept -> void {
-    mut ptr = reinterpret_cast<u64*>(raw);
+pub fn _mnew_aligned(Type type, u64 size, u64 align, bool huge) noexcept -> void* {
+    if (size == 0) {
+        return nullptr;
+    }
+    if ((align & (align - 1)) != 0) {
+        log::error("ustd::mem::mnew_aligned<{}>(size={}, align={}) -> Error(`align is not a power of 2`)", type, size, align);
+        return nullptr;
+    }
+    align = ustd::max(align, u64(16));
+
+    mut head = AlignedHeader{ nullptr, 0, size };
+    mut res  = static_cast<u8*>(nullptr);
 
-    try {
-        if (ptr != nullptr) {
-            ::__builtin_operator_delete(raw);
+    if (huge && size >= $mem_huge_page && Arena::current() == nullptr) {
+        res = map_huge(size, align, head);
+    }
+    if (res == nullptr) {
+        let raw = static_cast<u8*>(raw_new(size + align + $aligned_header));
+        if (raw == nullptr) {
+            log::error("ustd::mem::mnew_aligned<{}>(size={}, align={}) -> Error(`out of memory`)", type, size, align);
+            return nullptr;
         }
-        log::trace("ustd::mem::mdel<{}>(ptr={}) -> Ok()", type, ptr);
+        head._raw = raw;
+        res = reinterpret_cast<u8*>((u64(raw) + $aligned_header + align - 1) & ~(align - 1));
     }
-    catch(...) {
-        log::error("ustd::mem::mdel<{}>(ptr={}) -> Error()", type, ptr);
+
+    *reinterpret_cast<AlignedHeader*>(res - $aligned_header) = head;
+#if USTD_MEM_STATS
+    stats_alloc(type, size);
+#endif
+    return res;
+}
+
+pub fn _mdel_aligned(Type type, void* ptr) noexcept -> void {
+    if (ptr == nullptr) {
+        return;
+    }
+
+    let head = *reinterpret_cast<const AlignedHeader*>(static_cast<u8*>(ptr) - $aligned_header);
+#if USTD_MEM_STATS
+    stats_free(type, head._size);
+#else
+    (void)type;
+#endif
+
+#if defined(MADV_HUGEPAGE)
+    if (head._map != 0) {
+        ::munmap(head._raw, head._map);
         return;
     }
+#endif
+    raw_del(head._raw);
+}
+
+pub fn _mrenew(Type type, void* ptr, u64 keep_size, u64 new_size) noexcept -> void* {
+    if (ptr == nullptr) {
+        let cnt = new_size / ustd::max(u64(type._size), u64(1));
+        return _mnew(type, 1, &cnt);
+    }
+
+#if USTD_MEM_STATS
+    mut raw  = static_cast<u8*>(ptr) - $stats_header;
+    let prev = *reinterpret_cast<u64*>(raw);
+    mut res  = static_cast<u8*>(raw_renew(raw, $stats_header + keep_size, $stats_header + new_size));
+    if (res == nullptr) {
+        log::error("ustd::mem::mrenew<{}>(size={}) -> Error(`out of memory`)", type, new_size);
+        return nullptr;
+    }
+    *reinterpret_cast<u64*>(res) = new_size;
+    stats_free(type, prev);
+    stats_alloc(type, new_size);
+    return res + $stats_header;
+#else
+    let res = raw_renew(ptr, keep_size, new_size);
+    if (res == nullptr) {
+        log::error("ustd::mem::mrenew<{}>(size={}) -> Error(`out of memory`)", type, new_size);
+    }
+    return res;
+#endif
 }
 
 pub fn _mcpy(Type type, void* dst, const void* src, u32 rank, const u64 dims[]) noexcept -> void {
-    (void)type;
-    let dims_list = make_dims_list(rank, dims);
     let total_cnt = get_total_cnt(rank, dims);
     ustd_builtin(memcpy)(dst, src, type._size*total_cnt);
 }
+#pragma endregion
+
+#pragma region stats
+pub fn mem_stats() noexcept -> MemStats {
+    mut res = MemStats{};
+
+#if USTD_MEM_STATS
+    using sync::Ordering;
+
+    res._enabled     = true;
+    res._alloc_cnt   = sync::load(&_stats._alloc_cnt,   Ordering::Relaxed);
+    res._alloc_bytes = sync::load(&_stats._alloc_bytes, Ordering::Relaxed);
+    res._free_cnt    = sync::load(&_stats._free_cnt,    Ordering::Relaxed);
+    res._free_bytes  = sync::load(&_stats._free_bytes,  Ordering::Relaxed);
+    res._live_bytes  = sync::load(&_stats._live_bytes,  Ordering::Relaxed);
+    res._peak_bytes  = sync::load(&_stats._peak_bytes,  Ordering::Relaxed);
+    for (mut i = 0u; i < MemStats::$bins; ++i) {
+        res._bins[i] = sync::load(&_stats._bins[i], Ordering::Relaxed);
+    }
+
+    // one type may have a desc per translation unit, merge them by name
+    let slots = stats_slots();
+    for (mut i = 0u; i < MemStats::$max_types; ++i) {
+        let& slot = slots[i];
+        if (sync::load(&slot._key, Ordering::Acquire) == nullptr) continue;
+
+        let name = slot._stats._type.fullname();
+        mut dst  = static_cast<MemTypeStats*>(nullptr);
+        for (mut k = 0u; k < res._type_cnt; ++k) {
+            if (res._types[k]._type.fullname() == name) {
+                dst = &res._types[k];
+                break;
+            }
+        }
+        if (dst == nullptr) {
+            dst = &res._types[res._type_cnt++];
+            dst->_type = slot._stats._type;
+        }
+        dst->_alloc_cnt   += sync::load(&slot._stats._alloc_cnt,   Ordering::Relaxed);
+        dst->_alloc_bytes += sync::load(&slot._stats._alloc_bytes, Ordering::Relaxed);
+        dst->_free_cnt    += sync::load(&slot._stats._free_cnt,    Ordering::Relaxed);
+        dst->_free_bytes  += sync::load(&slot._stats._free_bytes,  Ordering::Relaxed);
+    }
+#endif
+
+    return res;
+}
+
+pub fn mem_stats_dump() noexcept -> void {
+    let stats = mem_stats();
+    if (!stats._enabled) {
+        log::info("ustd::mem::stats: disabled, build with USTD_MEM_STATS=1");
+        return;
+    }
+
+    log::info("ustd::mem::stats: alloc={}/{}B, free={}/{}B, live={}B, peak={}B",
+        stats._alloc_cnt, stats._alloc_bytes, stats._free_cnt, stats._free_bytes, stats._live_bytes, stats._peak_bytes);
+
+    for (mut i = 0u; i < stats._type_cnt; ++i) {
+        let& t = stats._types[i];
+        log::info("ustd::mem::stats[{}]: alloc={}/{}B, free={}/{}B, live={}B",
+            t._type, t._alloc_cnt, t._alloc_bytes, t._free_cnt, t._free_bytes, t.live_bytes());
+    }
+
+    for (mut i = 0u; i < MemStats::$bins; ++i) {
+        if (stats._bins[i] == 0) continue;
+        let lo = i == 0 ? u64(0) : u64(1) << (i - 1);
+        log::info("ustd::mem::stats[size>={}B]: {}", lo, stats._bins[i]);
+    }
+}
+#pragma endregion
+
+unittest(mem_stats) {
+    let s0 = mem_stats();
+    {
+        mut v = List<u64>::with_capacity(1000);
+        v.push(1ull);
+    }
+    let s1 = mem_stats();
+
+    if (!s1._enabled) {
+        assert_eq(s1._alloc_cnt, u64(0));
+        return;
+    }
+    assert_eq(s1._alloc_cnt - s0._alloc_cnt >= 1, true);
+    assert_eq(s1._alloc_bytes - s0._alloc_bytes >= 8000, true);
+    assert_eq(s1._peak_bytes >= 8000, true);
+}
+
+unittest(mnew_aligned) {
+    const u64 aligns[] = { 16, 64, 256, 4096 };
+    for (let align : aligns) {
+        mut p = mnew_aligned<f32>(1000, align);
+        assert_eq(u64(p) % align, u64(0));
+        p[999] = 1.0f;
+        mdel_aligned(p);
+    }
+
+    mut big = mnew_aligned<u8>(4 * $mem_huge_page, $mem_align, true);
+    assert_eq(u64(big) % $mem_align, u64(0));
+    big[0] = 1;
+    big[4 * $mem_huge_page - 1] = 1;
+    mdel_aligned(big);
+
+    // arena blocks
+    mut arena = Arena();
+    {
+        let scope = Arena::Scope(arena);
+        mut p = mnew_aligned<f64>(100, 128);
+        assert_eq(arena.contains(p), true);
+        assert_eq(u64(p) % 128, u64(0));
+        mdel_aligned(p);
+    }
+}
+
+unittest(mem_backend) {
+    let prev = get_mem_backend();
+    set_mem_backend(MemBackend::Slab);
+
+    mut small = List<u32>::with_capacity(10);
+    small.push(1u);
+    mut b = Box<u64>(42u);
+    assert_eq(slab::block_size(small._data) != 0, true);
+    assert_eq(slab::block_size(b._ptr) != 0, true);
+
+    // too large for a size class
+    mut large = List<u8>::with_capacity(slab::$max_size + 1);
+    assert_eq(slab::block_size(large._data), u64(0));
+
+    set_mem_backend(prev);
+
+    // slab blocks are freed after the switch
+    mut moved = as_mov(small);
+    (void)moved;
+}
 
 }
@@ -4,12 +4,29 @@
 #include "ustd/core/type.h"
 #include "ustd/core/vec.h"
 
+// USTD_MEM_STATS: 1 to count allocations, see `mem_stats`; 0 compiles the counters out
+#ifndef USTD_MEM_STATS
+#   define USTD_MEM_STATS 0
+#endif
+
 namespace ustd
 {
 
+// where `mnew` takes memory from, outside of an Arena::Scope
+enum class MemBackend
+{
+    System,     // global operator new
+    Slab,       // slab: thread-cached size classes up to slab::$max_size, operator new above
+};
+
+// process wide, blocks of either backend may be freed after a switch
+pub fn set_mem_backend(MemBackend backend) noexcept -> void;
+pub fn get_mem_backend() noexcept -> MemBackend;
+
 pub fn _mnew(Type type, u32 rank, const u64 dims[]) noexcept -> void*;
 pub fn _mdel(Type type, void* ptr)  noexcept -> void;
 pub fn _mcpy(Type type, void* dst, const void* src, u32 rank, const u64 dims[]) noexcept -> void;
+pub fn _mrenew(Type type, void* ptr, u64 keep_size, u64 new_size) noexcept -> void*;
 
 template<class T>
 fn mnew(u64 cnt) noexcept -> T* {
@@ -34,6 +51,17 @@ fn mdel(T* ptr) noexcept -> void {
     _mdel(typeof<T>(), ptr);
 }
 
+// mrenew: resize a block of `mnew`, in place when possible, the first `keep` elements are kept
+//  - the block is extended in place for the latest arena block, or when the slab size class has room,
+//    heap blocks go to realloc, which remaps large blocks (mremap) instead of copying them
+//  - nullptr when out of memory, `ptr` is still valid then
+template<class T>
+fn mrenew(T* ptr, u64 keep, u64 cnt) noexcept -> T* {
+    static_assert(trivially_relocatable<T>::$value, "ustd::mrenew: T is not trivially relocatable");
+    let res = _mrenew(typeof<T>(), ptr, sizeof(T) * keep, sizeof(T) * cnt);
+    return static_cast<T*>(res);
+}
+
 template<class T>
 fn mcpy(T* dst, const T* src, u64 count) -> void {
     _mcpy(typeof<T>(), dst, src, 1, &count);
@@ -62,4 +90,69 @@ fn mmov(T* dst, T* src, u64 count) -> void {
     }
 }
 
+#pragma region aligned
+// default alignment of `mnew_aligned`: a cache line, and the widest SIMD register
+constexpr static let $mem_align     = u64(64);
+
+// huge page size, blocks from this size on may be mapped with transparent huge pages
+constexpr static let $mem_huge_page = u64(2) << 20;
+
+// `size` bytes aligned to `align` (power of 2), free with `_mdel_aligned`
+//  - huge: map blocks of at least $mem_huge_page on huge page boundaries and madvise(MADV_HUGEPAGE),
+//    where the system has it, the heap otherwise
+pub fn _mnew_aligned(Type type, u64 size, u64 align, bool huge) noexcept -> void*;
+pub fn _mdel_aligned(Type type, void* ptr) noexcept -> void;
+
+template<class T>
+fn mnew_aligned(u64 cnt, u64 align = $mem_align, bool huge = false) noexcept -> T* {
+    let res = _mnew_aligned(typeof<T>(), sizeof(T) * cnt, align < alignof(T) ? u64(alignof(T)) : align, huge);
+    return static_cast<T*>(res);
+}
+
+template<class T>
+fn mdel_aligned(T* ptr) noexcept -> void {
+    _mdel_aligned(typeof<T>(), ptr);
+}
+#pragma endregion
+
+#pragma region stats
+// allocations of one type
+struct MemTypeStats
+{
+    Type    _type;
+    u64     _alloc_cnt;
+    u64     _alloc_bytes;
+    u64     _free_cnt;
+    u64     _free_bytes;
+
+    fn live_bytes() const noexcept -> u64 {
+        return _alloc_bytes - _free_bytes;
+    }
+};
+
+// allocation counters, all zero unless built with USTD_MEM_STATS=1
+struct MemStats
+{
+    constexpr static let $bins      = 48u;     // bin i: sizes in [2^(i-1), 2^i), bin 0: size 0
+    constexpr static let $max_types = 256u;
+
+    bool    _enabled;
+    u64     _alloc_cnt;
+    u64     _alloc_bytes;
+    u64     _free_cnt;
+    u64     _free_bytes;
+    u64     _live_bytes;
+    u64     _peak_bytes;
+    u64     _bins[$bins];
+    u32     _type_cnt;
+    MemTypeStats _types[$max_types];
+};
+
+// snapshot of the counters
+pub fn mem_stats() noexcept -> MemStats;
+
+// log the counters, at exit too when USTD_MEM_STATS=1
+pub fn mem_stats_dump() noexcept -> void;
+#pragma endregion
+
 }
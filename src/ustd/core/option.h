@@ -39,7 +39,6 @@ public:
     Option(Option&& other) noexcept: _valid(other._valid), _nil() {
         if (!_valid) return;
         ustd::ctor(&_val, as_mov(other._val));
-        new(&_val)T(as_mov(other._val));
     }
 
     // ctor[copy]
@@ -0,0 +1,436 @@
+#include "config.inl"
+
+namespace ustd::slab
+{
+
+using sync::Ordering;
+
+#pragma region class
+static constexpr u32 $sizes[$class_cnt] = {
+    16,   32,   48,   64,   80,   96,   112,  128,
+    160,  192,  224,  256,  320,  384,  448,  512,
+    640,  768,  896,  1024, 1280, 1536, 1792, 2048,
+    2560, 3072, 3584, 4096, 5120, 6144, 7168, 8192,
+};
+
+// size -> class: 16 byte steps up to 1024, 128 byte steps up to 8192
+struct ClassMap
+{
+    u8 _small[65];      // (size + 15) / 16
+    u8 _large[65];      // (size + 127) / 128
+
+    constexpr ClassMap() noexcept : _small{}, _large{} {
+        mut cls = 0u;
+        for (mut i = 0u; i <= 64; ++i) {
+            while ($sizes[cls] < i * 16) ++cls;
+            _small[i] = u8(cls);
+        }
+        cls = 0;
+        for (mut i = 0u; i <= 64; ++i) {
+            while ($sizes[cls] < i * 128) ++cls;
+            _large[i] = u8(cls);
+        }
+    }
+};
+
+static constexpr let $class_map = ClassMap();
+
+static fn size_class(u64 size) noexcept -> u32 {
+    if (size <= 1024) {
+        return $class_map._small[(size + 15) / 16];
+    }
+    return $class_map._large[(size + 127) / 128];
+}
+
+// blocks moved between a thread cache and the central list at once
+static fn batch_size(u32 cls) noexcept -> u32 {
+    let cnt = u32((16u << 10) / $sizes[cls]);
+    return ustd::min(ustd::max(cnt, 4u), 64u);
+}
+#pragma endregion
+
+#pragma region lock
+struct SpinLock
+{
+    u32 _flag;
+
+    fn lock() noexcept -> void {
+        while (sync::exchange(&_flag, 1u, Ordering::Acquire) != 0) {
+            while (sync::load(&_flag, Ordering::Relaxed) != 0) {
+#if defined(__x86_64__) || defined(__i386__)
+                __builtin_ia32_pause();
+#endif
+            }
+        }
+    }
+
+    fn unlock() noexcept -> void {
+        sync::store(&_flag, 0u, Ordering::Release);
+    }
+};
+#pragma endregion
+
+#pragma region page map
+// span address -> class + 1, two levels over 48 bit addresses, 0 for memory of others
+static constexpr let $leaf_bits = 16u;
+static constexpr let $root_bits = 48u - 16u - $leaf_bits;
+
+static u8* _page_map[1u << $root_bits];
+
+static fn page_class(const void* ptr) noexcept -> u32 {
+    let addr = u64(ptr);
+    if ((addr >> 48) != 0) {
+        return 0;
+    }
+
+    let leaf = sync::load(&_page_map[addr >> (16 + $leaf_bits)], Ordering::Acquire);
+    if (leaf == nullptr) {
+        return 0;
+    }
+    return leaf[(addr >> 16) & ((1u << $leaf_bits) - 1)];
+}
+
+static fn page_set(const void* span, u32 cls) noexcept -> void {
+    let addr = u64(span);
+    mut& root = _page_map[addr >> (16 + $leaf_bits)];
+
+    mut leaf = sync::load(&root, Ordering::Acquire);
+    if (leaf == nullptr) {
+        let bytes = u64(1) << $leaf_bits;
+        mut tmp   = static_cast<u8*>(::__builtin_operator_new(bytes));
+        ustd_builtin(memset)(tmp, 0, bytes);
+        if (sync::compare_exchange(&root, static_cast<u8*>(nullptr), tmp)) {
+            leaf = tmp;
+        }
+        else {
+            ::__builtin_operator_delete(tmp);
+            leaf = sync::load(&root, Ordering::Acquire);
+        }
+    }
+    sync::store(&leaf[(addr >> 16) & ((1u << $leaf_bits) - 1)], u8(cls + 1), Ordering::Release);
+}
+#pragma endregion
+
+#pragma region span
+static constexpr let $chunk_spans = 64u;
+
+struct SpanPool
+{
+    SpinLock    _lock;
+    u8*         _next;
+    u32         _left;
+};
+
+static SpanPool _spans;
+
+// 64KB aligned, carved from 4MB chunks
+static fn new_span() noexcept -> u8* {
+    _spans._lock.lock();
+    if (_spans._left == 0) {
+        mut raw = static_cast<u8*>(nullptr);
+        try {
+            raw = static_cast<u8*>(::__builtin_operator_new($span_size * ($chunk_spans + 1)));
+        }
+        catch (...) {
+            _spans._lock.unlock();
+            return nullptr;
+        }
+        _spans._next = reinterpret_cast<u8*>((u64(raw) + $span_size - 1) & ~($span_size - 1));
+        _spans._left = $chunk_spans;
+    }
+
+    let res = _spans._next;
+    _spans._next += $span_size;
+    _spans._left -= 1;
+    _spans._lock.unlock();
+    return res;
+}
+#pragma endregion
+
+#pragma region central
+// free blocks are linked through their first word
+struct Block
+{
+    Block* _next;
+};
+
+struct alignas(64) Central
+{
+    SpinLock    _lock;
+    Block*      _head;
+    u32         _cnt;
+};
+
+static Central _central[$class_cnt];
+
+// up to `cnt` blocks into `out`, a new span when the list is empty
+static fn central_take(u32 cls, u32 cnt, Block*& out) noexcept -> u32 {
+    mut& c = _central[cls];
+    c._lock.lock();
+
+    if (c._head == nullptr) {
+        c._lock.unlock();
+
+        let span = new_span();
+        if (span == nullptr) {
+            return 0;
+        }
+        page_set(span, cls);
+
+        let size = $sizes[cls];
+        let num  = u32($span_size / size);
+        for (mut i = 0u; i + 1 < num; ++i) {
+            reinterpret_cast<Block*>(span + i * size)->_next = reinterpret_cast<Block*>(span + (i + 1) * size);
+        }
+        reinterpret_cast<Block*>(span + (num - 1) * size)->_next = nullptr;
+
+        // keep `cnt`, the rest goes to the central list
+        let take = ustd::min(cnt, num);
+        out = reinterpret_cast<Block*>(span);
+        if (take < num) {
+            let last = reinterpret_cast<Block*>(span + (take - 1) * size);
+            let rest = last->_next;
+            last->_next = nullptr;
+
+            mut tail = reinterpret_cast<Block*>(span + (num - 1) * size);
+            c._lock.lock();
+            tail->_next = c._head;
+            c._head = rest;
+            c._cnt += num - take;
+            c._lock.unlock();
+        }
+        return take;
+    }
+
+    mut head = c._head;
+    mut tail = head;
+    mut take = 1u;
+    while (take < cnt && tail->_next != nullptr) {
+        tail = tail->_next;
+        take += 1;
+    }
+    c._head = tail->_next;
+    c._cnt -= take;
+    c._lock.unlock();
+
+    tail->_next = nullptr;
+    out = head;
+    return take;
+}
+
+static fn central_give(u32 cls, Block* head, Block* tail, u32 cnt) noexcept -> void {
+    mut& c = _central[cls];
+    c._lock.lock();
+    tail->_next = c._head;
+    c._head = head;
+    c._cnt += cnt;
+    c._lock.unlock();
+}
+#pragma endregion
+
+#pragma region cache
+struct Bin
+{
+    Block*  _head;
+    u32     _cnt;
+};
+
+// trivially destructible, so the fast path needs no TLS guard
+struct Cache
+{
+    Bin     _bins[$class_cnt];
+    bool    _dead;      // after thread exit cleanup: go to the central lists
+};
+
+static thread_local Cache _tls_cache;
+
+static fn cache_flush(Cache& cache) noexcept -> void {
+    for (mut cls = 0u; cls < $class_cnt; ++cls) {
+        mut& bin = cache._bins[cls];
+        if (bin._head == nullptr) continue;
+
+        mut tail = bin._head;
+        while (tail->_next != nullptr) tail = tail->_next;
+        central_give(cls, bin._head, tail, bin._cnt);
+        bin._head = nullptr;
+        bin._cnt  = 0;
+    }
+}
+
+// flushes the cache when the thread exits
+struct CacheGuard
+{
+    bool _init;
+
+    ~CacheGuard() noexcept {
+        cache_flush(_tls_cache);
+        _tls_cache._dead = true;
+    }
+};
+
+static thread_local CacheGuard _tls_guard;
+
+static fn cache_refill(Cache& cache, u32 cls) noexcept -> void* {
+    if (cache._dead) {
+        mut out = static_cast<Block*>(nullptr);
+        return central_take(cls, 1, out) == 0 ? nullptr : out;
+    }
+
+    _tls_guard._init = true;    // registers the exit cleanup
+
+    mut out = static_cast<Block*>(nullptr);
+    let cnt = central_take(cls, batch_size(cls), out);
+    if (cnt == 0) {
+        return nullptr;
+    }
+
+    mut& bin = cache._bins[cls];
+    bin._head = out->_next;
+    bin._cnt  = cnt - 1;
+    return out;
+}
+
+static fn cache_release(Cache& cache, u32 cls) noexcept -> void {
+    mut& bin = cache._bins[cls];
+    let  cnt = batch_size(cls);
+
+    mut tail = bin._head;
+    for (mut i = 1u; i < cnt; ++i) {
+        tail = tail->_next;
+    }
+    let head  = bin._head;
+    bin._head = tail->_next;
+    bin._cnt -= cnt;
+    central_give(cls, head, tail, cnt);
+}
+#pragma endregion
+
+#pragma region export
+pub fn alloc(u64 size) noexcept -> void* {
+    if (size > $max_size) {
+        return nullptr;
+    }
+
+    let cls  = size_class(size);
+    mut& bin = _tls_cache._bins[cls];
+    mut blk  = bin._head;
+    if (blk == nullptr) {
+        return cache_refill(_tls_cache, cls);
+    }
+    bin._head = blk->_next;
+    bin._cnt -= 1;
+    return blk;
+}
+
+pub fn free(void* ptr) noexcept -> bool {
+    let tag = page_class(ptr);
+    if (tag == 0) {
+        return false;
+    }
+
+    let cls = tag - 1;
+    mut blk = static_cast<Block*>(ptr);
+    mut& cache = _tls_cache;
+    if (cache._dead) {
+        central_give(cls, blk, blk, 1);
+        return true;
+    }
+
+    mut& bin = cache._bins[cls];
+    blk->_next = bin._head;
+    bin._head  = blk;
+    bin._cnt  += 1;
+    if (bin._cnt > 2 * batch_size(cls)) {
+        cache_release(cache, cls);
+    }
+    return true;
+}
+
+pub fn block_size(const void* ptr) noexcept -> u64 {
+    let tag = page_class(ptr);
+    return tag == 0 ? 0 : $sizes[tag - 1];
+}
+
+pub fn flush() noexcept -> void {
+    cache_flush(_tls_cache);
+}
+#pragma endregion
+
+unittest(slab) {
+    assert_eq(size_class(1), 0u);
+    assert_eq(size_class(16), 0u);
+    assert_eq(size_class(17), 1u);
+    assert_eq(size_class(1024), 19u);
+    assert_eq(size_class(1025), 20u);
+    assert_eq(size_class(8192), 31u);
+
+    const u64 sizes[] = { 1, 16, 24, 100, 500, 1000, 3000, 8192 };
+    for (let size : sizes) {
+        let p = slab::alloc(size);
+        assert_eq(p != nullptr, true);
+        assert_eq(u64(p) % 16, u64(0));
+        assert_eq(slab::block_size(p) >= size, true);
+        ustd_builtin(memset)(p, 0xAB, size);
+        assert_eq(slab::free(p), true);
+    }
+
+    assert_eq(slab::alloc($max_size + 1) == nullptr, true);
+
+    mut heap = mnew<u8>(64);
+    assert_eq(slab::block_size(heap), u64(0));
+    mdel(heap);
+}
+
+// every thread keeps 64 blocks live, each stamped with its owner and round at both ends;
+//  a block handed to two threads, or freed into the wrong class, breaks a stamp
+static fn slab_churn(u32 threads, u32 rounds) noexcept -> void {
+    thread::parallel_for(thread::Range{ 0, threads }, 1, [&](thread::Range r) {
+        for (mut t = r._start; t < r._end; ++t) {
+            void* live[64] = {};
+            u64   stamp[64] = {};
+            usize words[64] = {};
+            for (mut i = 0u; i < rounds; ++i) {
+                let k = (i * 7 + t) % 64;
+                if (live[k] != nullptr) {
+                    let p = static_cast<u64*>(live[k]);
+                    test::assert_eq(p[0], stamp[k]);
+                    test::assert_eq(p[words[k] - 1], stamp[k]);
+                    slab::free(live[k]);
+                }
+
+                let size = 16 + (i % 32) * 16;
+                live[k]  = slab::alloc(size);
+                stamp[k] = (u64(t) << 32) | i;
+                words[k] = size / 8;
+
+                let p = static_cast<u64*>(live[k]);
+                p[0] = stamp[k];
+                p[words[k] - 1] = stamp[k];
+            }
+            for (mut k = 0u; k < 64; ++k) {
+                if (live[k] == nullptr) continue;
+                let p = static_cast<u64*>(live[k]);
+                test::assert_eq(p[0], stamp[k]);
+                test::assert_eq(p[words[k] - 1], stamp[k]);
+                slab::free(live[k]);
+            }
+        }
+    }, thread::Partition::Static);
+}
+
+unittest(slab_threads) {
+    slab_churn(8, 5000);
+}
+
+unittest(slab_threads_perf) {
+    let threads = 32u;
+    let rounds  = 20000u;
+
+    let t0 = time::Instant::now();
+    slab_churn(threads, rounds);
+    let t1 = time::Instant::now();
+
+    log::info("ustd::slab: {} threads x {} alloc/free in {}", threads, rounds, t1 - t0);
+}
+
+}
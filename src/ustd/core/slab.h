@@ -0,0 +1,35 @@
+#pragma once
+
+#include "ustd/core/builtin.h"
+
+namespace ustd
+{
+
+// slab: size-class allocator for small blocks, the `MemBackend::Slab` of `mnew`
+//  - 32 classes from 16 to 8192 bytes, blocks are 16 aligned
+//  - every thread caches free blocks per class, so alloc and free take no lock,
+//    full or empty caches move a batch to or from the central list of the class
+//  - blocks live in 64KB spans that are never given back to the system,
+//    a page map tells slab blocks from heap blocks, so `free` takes any pointer
+namespace slab
+{
+
+constexpr static let $max_size  = u64(8192);
+constexpr static let $class_cnt = 32u;
+constexpr static let $span_size = u64(64) << 10;
+
+// nullptr when `size` > $max_size or out of memory
+pub fn alloc(u64 size) noexcept -> void*;
+
+// false when `ptr` is not a slab block
+pub fn free(void* ptr) noexcept -> bool;
+
+// block size of a slab block, 0 for other pointers
+pub fn block_size(const void* ptr) noexcept -> u64;
+
+// give the blocks cached by this thread back to the central lists
+pub fn flush() noexcept -> void;
+
+}
+
+}
@@ -0,0 +1,206 @@
+#include "config.inl"
+
+namespace ustd
+{
+
+#pragma region simd
+#if defined(__AVX2__)
+#   define USTD_BYTES_SIMD 32
+#elif defined(__SSE2__)
+#   define USTD_BYTES_SIMD 16
+#else
+#   define USTD_BYTES_SIMD 0
+#endif
+
+#if USTD_BYTES_SIMD
+constexpr static let $vec = usize(USTD_BYTES_SIMD);
+
+using bytes_t = u8   __attribute__((vector_size(USTD_BYTES_SIMD)));
+using mask_t  = char __attribute__((vector_size(USTD_BYTES_SIMD)));
+
+static fn vload(const u8* p) noexcept -> bytes_t {
+    mut res = bytes_t{};
+    __builtin_memcpy(&res, p, sizeof(bytes_t));
+    return res;
+}
+
+// bit i: lane i of `cmp` is set
+template<class V>
+static fn vmask(V cmp) noexcept -> u32 {
+#if USTD_BYTES_SIMD == 32
+    return u32(__builtin_ia32_pmovmskb256(__builtin_bit_cast(mask_t, cmp)));
+#else
+    return u32(__builtin_ia32_pmovmskb128(__builtin_bit_cast(mask_t, cmp)));
+#endif
+}
+#endif
+#pragma endregion
+
+#pragma region bytes
+pub fn _bytes_find(const u8* s, usize n, u8 c) noexcept -> usize {
+    mut i = usize(0);
+
+#if USTD_BYTES_SIMD
+    let pat = bytes_t{} + c;
+
+    // four vectors per step until a hit, then locate it
+    for (; i + 4 * $vec <= n; i += 4 * $vec) {
+        let m0 = vload(s + i)            == pat;
+        let m1 = vload(s + i + $vec)     == pat;
+        let m2 = vload(s + i + 2 * $vec) == pat;
+        let m3 = vload(s + i + 3 * $vec) == pat;
+        if (vmask(m0 | m1 | m2 | m3) != 0) break;
+    }
+    for (; i + $vec <= n; i += $vec) {
+        let bits = vmask(vload(s + i) == pat);
+        if (bits != 0) {
+            return i + usize(__builtin_ctz(bits));
+        }
+    }
+#endif
+
+    for (; i < n; ++i) {
+        if (s[i] == c) return i;
+    }
+    return n;
+}
+
+pub fn _bytes_rfind(const u8* s, usize n, u8 c) noexcept -> usize {
+    mut i = n;
+
+#if USTD_BYTES_SIMD
+    let pat = bytes_t{} + c;
+    for (; i >= $vec; i -= $vec) {
+        let bits = vmask(vload(s + i - $vec) == pat);
+        if (bits != 0) {
+            return i - $vec + usize(31 - __builtin_clz(bits));
+        }
+    }
+#endif
+
+    for (; i != 0; --i) {
+        if (s[i - 1] == c) return i - 1;
+    }
+    return n;
+}
+
+pub fn _bytes_count(const u8* s, usize n, u8 c) noexcept -> usize {
+    mut i   = usize(0);
+    mut res = usize(0);
+
+#if USTD_BYTES_SIMD
+    let pat = bytes_t{} + c;
+    for (; i + $vec <= n; i += $vec) {
+        res += usize(__builtin_popcount(vmask(vload(s + i) == pat)));
+    }
+#endif
+
+    for (; i < n; ++i) {
+        res += s[i] == c ? 1 : 0;
+    }
+    return res;
+}
+
+// first and last byte of the needle filter candidates, memcmp checks the middle
+pub fn _bytes_search(const u8* s, usize n, const u8* w, usize m) noexcept -> usize {
+    if (m == 0) return 0;
+    if (m > n)  return n;
+    if (m == 1) return _bytes_find(s, n, w[0]);
+
+    mut i = usize(0);
+
+#if USTD_BYTES_SIMD
+    let first = bytes_t{} + w[0];
+    let last  = bytes_t{} + w[m - 1];
+    for (; i + m - 1 + $vec <= n; i += $vec) {
+        let hit0 = vload(s + i)         == first;
+        let hit1 = vload(s + i + m - 1) == last;
+        for (mut bits = vmask(hit0 & hit1); bits != 0; bits &= bits - 1) {
+            let k = i + usize(__builtin_ctz(bits));
+            if (__builtin_memcmp(s + k + 1, w + 1, m - 2) == 0) {
+                return k;
+            }
+        }
+    }
+#endif
+
+    for (; i + m <= n; ++i) {
+        if (s[i] == w[0] && s[i + m - 1] == w[m - 1] && __builtin_memcmp(s + i + 1, w + 1, m - 2) == 0) {
+            return i;
+        }
+    }
+    return n;
+}
+#pragma endregion
+
+unittest(Slice_bytes) {
+    char text[300] = {};
+    for (mut i = 0u; i < 300; ++i) {
+        text[i] = char('a' + (i * 7) % 13);
+    }
+
+    // every length and offset against the scalar definition
+    for (mut len = 0u; len <= 300; len += 7) {
+        let s = str(text, len);
+        for (mut c = 'a'; c <= 'n'; ++c) {
+            mut first = usize(len);
+            mut last  = usize(len);
+            mut cnt   = usize(0);
+            for (mut i = 0u; i < len; ++i) {
+                if (text[i] != c) continue;
+                if (first == len) first = i;
+                last = i;
+                cnt += 1;
+            }
+            assert_eq(s.find(c).is_some() ? s.find(c)._val : usize(len), first);
+            assert_eq(s.rfind(c).is_some() ? s.rfind(c)._val : usize(len), last);
+            assert_eq(s.count_of(c), cnt);
+            assert_eq(s.contains(c), cnt != 0);
+        }
+    }
+
+    let s = str("GET /index.html HTTP/1.1\r\nHost: localhost\r\n\r\nbody");
+    assert_eq(s.find_slice("\r\n\r\n"), Option<usize>::Some(41));
+    assert_eq(s.find_slice("HTTP/1.1"), Option<usize>::Some(16));
+    assert_eq(s.find_slice("HTTP/2"), Option<usize>::None());
+    assert_eq(s.find_slice(""), Option<usize>::Some(0));
+    assert_eq(str("").find_slice(""), Option<usize>::Some(0));
+    assert_eq(s.contains_slice("Host:"), true);
+    assert_eq(s.starts_with("GET "), true);
+    assert_eq(s.ends_with("body"), true);
+    assert_eq(s.ends_with("bodyy"), false);
+    assert_eq(s.starts_with(""), true);
+
+    // needle across vector boundaries
+    mut big = String::with_capacity(4096);
+    big.pushn(4000, 'x');
+    big.push_slice(str("needle"));
+    assert_eq(str(big).find_slice("needle"), Option<usize>::Some(4000));
+    assert_eq(str(big).find_slice("needlf"), Option<usize>::None());
+}
+
+unittest(Slice_bytes_perf) {
+    let len = usize(1) << 24;
+    mut buf = String::with_capacity(len);
+    buf.pushn(len - 1, 'a');
+    buf.push('\n');
+    let s = str(buf);
+
+    let t0 = time::Instant::now();
+    let i0 = s.find('\n');
+    let t1 = time::Instant::now();
+    let c0 = s.count_of('a');
+    let t2 = time::Instant::now();
+    let i1 = s.find_slice("a\n");
+    let t3 = time::Instant::now();
+
+    assert_eq(i0, Option<usize>::Some(len - 1));
+    assert_eq(c0, len - 1);
+    assert_eq(i1, Option<usize>::Some(len - 2));
+
+    let mb = f64(len) / f64(1 << 20);
+    log::info("ustd::Slice: find={}MB/s, count_of={}MB/s, find_slice={}MB/s",
+        u64(mb / (t1 - t0).total_secs()), u64(mb / (t2 - t1).total_secs()), u64(mb / (t3 - t2).total_secs()));
+}
+
+}
@@ -17,19 +17,30 @@ using str = Slice<const char>;
 template<class T>
 fn mcpy(T* dst, const T* src, u64 size) -> void;
 
+#pragma region bytes
+// byte search kernels of Slice, SSE2/AVX2 where the target has them, `n` when nothing is found
+pub fn _bytes_find  (const u8* s, usize n, u8 c) noexcept -> usize;
+pub fn _bytes_rfind (const u8* s, usize n, u8 c) noexcept -> usize;
+pub fn _bytes_count (const u8* s, usize n, u8 c) noexcept -> usize;
+pub fn _bytes_search(const u8* s, usize n, const u8* w, usize m) noexcept -> usize;
+#pragma endregion
+
 template<typename T>
 struct Slice
 {
-    T* _data       = nullptr;
-    u32 _size       = 0;
-    u32 _capacity   = 0;
+    // char and u8 slices search with the byte kernels
+    constexpr static bool $bytes = sizeof(T) == 1 && trait<T>::$int;
+
+    T*      _data       = nullptr;
+    usize   _size       = 0;
+    usize   _capacity   = 0;
 
 #pragma region ctor
     // ctor:
     constexpr Slice() noexcept = default;
 
     // ctor:
-    constexpr Slice(T* ptr, u32 length, u32 capacity = 0)
+    constexpr Slice(T* ptr, usize length, usize capacity = 0)
         : _data{ ptr }, _size{ length }, _capacity{ capacity }
     {}
 
@@ -51,19 +62,19 @@ struct Slice
         return _data;
     }
 
-    fn len() const noexcept -> u32 {
+    fn len() const noexcept -> usize {
         return _size;
     }
 
-    fn size() const noexcept -> u32 {
+    fn size() const noexcept -> usize {
         return _size;
     }
 
-    fn count() const noexcept -> u32 {
+    fn count() const noexcept -> usize {
         return _size;
     }
 
-    fn capacity() const noexcept -> u32 {
+    fn capacity() const noexcept -> usize {
         return _capacity;
     }
 
@@ -78,12 +89,12 @@ struct Slice
 
 #pragma region access
     // operator: []
-    fn operator[](u32 i) const noexcept -> const T& {
+    fn operator[](usize i) const noexcept -> const T& {
         return _data[i];
     }
 
     // operator: []
-    fn operator[](u32 i) noexcept -> T& {
+    fn operator[](usize i) noexcept -> T& {
         return _data[i];
     }
 #pragma endregion
@@ -91,13 +102,13 @@ struct Slice
 #pragma region method
 
     // method: slice
-    fn slice(u32 beg, u32 end) const noexcept-> Slice {
+    fn slice(usize beg, usize end) const noexcept-> Slice {
         return { _data + beg, end - beg + 1 };
     }
 
     fn slice(i32 beg, i32 end) const noexcept -> Slice {
-        let beg_pos = u32(beg + i32(_size)) % _size;
-        let end_pos = u32(end + i32(_size)) % _size;
+        let beg_pos = usize(i64(beg) + i64(_size)) % _size;
+        let end_pos = usize(i64(end) + i64(_size)) % _size;
         return { _data + beg_pos, end_pos - beg_pos + 1 };
     }
 
@@ -107,7 +118,7 @@ struct Slice
         _size   = 0;
 
         if (!trivial<T>::$dtor) {
-            for (mut i = 0u; i < cnt; ++i) {
+            for (mut i = usize(0); i < cnt; ++i) {
                 ustd::dtor(&_data[i]);
             }
         }
@@ -117,13 +128,7 @@ struct Slice
     fn operator==(Slice<const T> other) const noexcept -> bool {
         if (_size != other._size) return false;
         if (_data == other._data) return true;
-
-        for (mut i = 0u; i < _size; ++i) {
-            if (_data[i] != other._data[i]) {
-                return false;
-            }
-        }
-        return true;
+        return _equal(_data, other._data, _size);
     }
 
     // operator: neq
@@ -137,10 +142,7 @@ struct Slice
         if (prefix._size > _size) {
             return false;
         }
-
-        let tmp = this->slice(0u, prefix._size - 1);
-        let res = tmp == prefix;
-        return res;
+        return _equal(_data, prefix._data, prefix._size);
     }
 
     // method: ends_with
@@ -148,15 +150,15 @@ struct Slice
         if (suffix._size > _size) {
             return false;
         }
-
-        let tmp = this->slice(_size - 1 - suffix._size, _size - 1);
-        let res = tmp == suffix;
-        return res;
+        return _equal(_data + (_size - suffix._size), suffix._data, suffix._size);
     }
 
     // method: contains
     fn contains(const T& val) const noexcept -> bool {
-        for (mut i = 0u; i < _size; ++i) {
+        if constexpr ($bytes) {
+            return _bytes_find(_bytes(), _size, u8(val)) != _size;
+        }
+        for (mut i = usize(0); i < _size; ++i) {
             if (_data[i] == val) {
                 return true;
             }
@@ -164,11 +166,28 @@ struct Slice
         return false;
     }
 
+    // method: contains_slice
+    fn contains_slice(Slice<const T> needle) const noexcept -> bool {
+        return find_slice(needle).is_some();
+    }
+
+    // method: count_of, occurrences of `val`
+    fn count_of(const T& val) const noexcept -> usize {
+        if constexpr ($bytes) {
+            return _bytes_count(_bytes(), _size, u8(val));
+        }
+        mut res = usize(0);
+        for (mut i = usize(0); i < _size; ++i) {
+            res += _data[i] == val ? 1 : 0;
+        }
+        return res;
+    }
+
     // method: replace
     template<class ...U>
     fn replace(const T& from, U&& ...u) noexcept -> void {
         let cnt = _size;
-        for (mut i = 0u; i < cnt; ++i) {
+        for (mut i = usize(0); i < cnt; ++i) {
             if (_data[i] == from) {
                 ustd::ctor(&_data[i], as_fwd<U>(u)...);
             }
@@ -177,30 +196,78 @@ struct Slice
 
     // method: find
     template<class ...U>
-    fn find(U&& ...u) const noexcept -> Option<u32> {
+    fn find(U&& ...u) const noexcept -> Option<usize> {
+        let val = T(as_fwd<U>(u)...);
         let cnt = _size;
-        for (mut i = 0u; i < cnt; ++i) {
-            if (_data[i] == T(as_fwd<U>(u)...) ) {
-                return Option<u32>::Some(i);
+        if constexpr ($bytes) {
+            let idx = _bytes_find(_bytes(), cnt, u8(val));
+            return idx == cnt ? Option<usize>::None() : Option<usize>::Some(idx);
+        }
+        for (mut i = usize(0); i < cnt; ++i) {
+            if (_data[i] == val) {
+                return Option<usize>::Some(i);
             }
         }
-        return Option<u32>::None();
+        return Option<usize>::None();
     }
 
-    // method: find
+    // method: rfind
     template<class ...U>
-    fn rfind(U&& ...u) const noexcept -> Option<u32> {
+    fn rfind(U&& ...u) const noexcept -> Option<usize> {
+        let val = T(as_fwd<U>(u)...);
         let cnt = _size;
+        if constexpr ($bytes) {
+            let idx = _bytes_rfind(_bytes(), cnt, u8(val));
+            return idx == cnt ? Option<usize>::None() : Option<usize>::Some(idx);
+        }
         for (mut i = cnt; i != 0; --i) {
-            if (_data[i] == T(as_fwd<U>(u)...)) {
-                return Option<u32>::Some(i);
+            if (_data[i - 1] == val) {
+                return Option<usize>::Some(i - 1);
+            }
+        }
+        return Option<usize>::None();
+    }
+
+    // method: find_slice, first position of `needle`
+    fn find_slice(Slice<const T> needle) const noexcept -> Option<usize> {
+        if (needle._size == 0) {
+            return Option<usize>::Some(0);
+        }
+        if (needle._size > _size) {
+            return Option<usize>::None();
+        }
+        if constexpr ($bytes) {
+            let idx = _bytes_search(_bytes(), _size, reinterpret_cast<const u8*>(needle._data), needle._size);
+            return idx == _size ? Option<usize>::None() : Option<usize>::Some(idx);
+        }
+        for (mut i = usize(0); i + needle._size <= _size; ++i) {
+            if (_equal(_data + i, needle._data, needle._size)) {
+                return Option<usize>::Some(i);
             }
         }
-        return Option<u32>::None();
+        return Option<usize>::None();
     }
 
 #pragma endregion
 
+private:
+    fn _bytes() const noexcept -> const u8* {
+        return reinterpret_cast<const u8*>(_data);
+    }
+
+    static fn _equal(const T* a, const T* b, usize n) noexcept -> bool {
+        if constexpr ($bytes) {
+            return n == 0 || __builtin_memcmp(a, b, n) == 0;
+        }
+        for (mut i = usize(0); i < n; ++i) {
+            if (a[i] != b[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+public:
 #pragma region iter
     // iter:
     fn into_iter() const noexcept -> Iter<const_t<T>> {
@@ -226,7 +293,7 @@ public:
 
     // method: push
     template<class ...U>
-    fn pushn(u32 n, U&& ...u) noexcept -> Option<Slice&> {
+    fn pushn(usize n, U&& ...u) noexcept -> Option<Slice&> {
         if (_size + n > _capacity) {
             return Option<Slice&>::None();
         }
@@ -258,8 +325,8 @@ protected:
 
     // method: push
     template<class ...U>
-    fn _pushn(u32 n, U&& ...u) noexcept -> void {
-        for (mut i = 0u; i < n; ++i) {
+    fn _pushn(usize n, U&& ...u) noexcept -> void {
+        for (mut i = usize(0); i < n; ++i) {
             ustd::ctor(&_data[_size++], as_fwd<U>(u)...);
         }
     }
@@ -58,10 +58,12 @@ struct FixedCStr : public FixedStr<N - 1>
     }
 };
 
-pub fn hash(str s)          noexcept -> u32;
 pub fn cstr(const char* s)  noexcept -> str;
 
 #pragma region parse_num
+// str_parse_num: parse a number at the front of `s`, `rem` gets the unparsed rest
+//  - integers: decimal or `0x` hex, None when out of the range of T
+//  - floats: correctly rounded, `inf`/`nan` accepted, no locale and no hex floats
 template<class T>
 fn str_parse_num(str s, str* rem=nullptr) noexcept -> Option<T>;
 
@@ -2,3 +2,4 @@
 
 #include "ustd/fs/path.h"
 #include "ustd/fs/file.h"
+#include "ustd/fs/mmap.h"
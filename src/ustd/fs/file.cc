@@ -17,6 +17,7 @@ pub fn to_str(FileMode mode) noexcept->str {
     switch(mode) {
         case FileMode::Create:  return "Create";
         case FileMode::Open:    return "Open";
+        case FileMode::Edit:    return "Edit";
     }
     return "";
 }
@@ -49,7 +50,7 @@ pub File::File(Path path, Mode mode, Type type) noexcept: _fid(fid_t::Invalid) {
 
     let full_path = path.get_fullpath();
 
-    let open_flag = mode == Mode::Open ? O_RDONLY : (O_RDWR | O_CREAT | O_TRUNC);
+    let open_flag = mode == Mode::Open ? O_RDONLY : mode == Mode::Edit ? O_RDWR : (O_RDWR | O_CREAT | O_TRUNC);
 
 #ifdef _UCRT
     let share_flag = _SH_DENYWR;
@@ -75,7 +76,7 @@ pub File::File(Path path, Mode mode, Type type) noexcept: _fid(fid_t::Invalid) {
     }
 }
 
-pub fn File::open_impl(Path path, Type type) noexcept -> Result<File> {
+pub fn File::open_impl(Path path, Type type, Mode mode) noexcept -> Result<File> {
 
     if (path.is_empty()) {
         log::error("ustd::fs::File.open_impl(path=`{}`, type=`{}`): path is empty!!!", path, type);
@@ -92,7 +93,7 @@ pub fn File::open_impl(Path path, Type type) noexcept -> Result<File> {
         return Result<File>::Err(os::Error::NotFound);
     }
 
-    mut res = File(path, FileMode::Open, type);
+    mut res = File(path, mode, type);
     if (res._fid == fid_t::Invalid) {
         let eid = os::get_error();
         log::warn("ustd::fs::File.open_impl(path=`{}`, type=`{}`): error = {}", path, type, eid);
@@ -157,6 +158,11 @@ pub fn File::open(Path path) noexcept -> Result<File> {
     return open_impl(path, Type::Binary);
 }
 
+// ctor
+pub fn File::edit(Path path) noexcept -> Result<File> {
+    return open_impl(path, Type::Binary, Mode::Edit);
+}
+
 // property[r]: is_valid
 pub fn File::is_valid() const noexcept {
     return _fid != fid_t::Invalid;
@@ -203,17 +209,35 @@ pub fn File::seek(SeekFrom pos) noexcept -> Result<u64> {
     return Result<u64>::Ok(u64(res));
 }
 
+// bytes per read/write call, the systems take 32 bit counts
+static constexpr let $io_chunk = u64(1) << 30;
+
 pub fn File::read(void* dat, u64 size) noexcept -> Result<u64> {
     if (_fid == fid_t::Invalid) {
         return Result<u64>::Err(os::Error::InvalidData);
     }
 
-    let ret = ::_read(int(_fid), dat, u32(size));
+    // large reads in chunks, until a short read
+    mut ptr = static_cast<u8*>(dat);
+    mut cnt = u64(0);
+    do {
+        let len = ustd::min(size - cnt, $io_chunk);
+        let ret = ::_read(int(_fid), ptr + cnt, u32(len));
+
+        if (ret < 0) {
+            if (cnt != 0) break;
+            return Result<u64>::Err(os::get_error());
+        }
+        if (ret == 0) {
+            if (cnt != 0) break;
+            return Result<u64>::Err(os::Error::UnexpectedEof);
+        }
 
-    if (ret < 0)  return Result<u64>::Err(os::get_error());
-    if (ret == 0) return Result<u64>::Err(os::Error::UnexpectedEof);
+        cnt += u64(ret);
+        if (u64(ret) < len) break;
+    } while (cnt < size);
 
-    return Result<u64>::Ok(u64(ret));
+    return Result<u64>::Ok(cnt);
 }
 
 pub fn File::write(const void* dat, u64 size) noexcept -> Result<u64> {
@@ -221,12 +245,19 @@ pub fn File::write(const void* dat, u64 size) noexcept -> Result<u64> {
         return Result<u64>::Err(os::Error::InvalidData);
     }
 
-    let ret = ::_write(int(_fid), dat, u32(size));
+    mut ptr = static_cast<const u8*>(dat);
+    mut cnt = u64(0);
+    do {
+        let len = ustd::min(size - cnt, $io_chunk);
+        let ret = ::_write(int(_fid), ptr + cnt, u32(len));
+
+        if (ret <  0) return Result<u64>::Err(os::get_error());
+        if (ret == 0) return Result<u64>::Err(os::Error::UnexpectedEof);
 
-    if (ret <  0) return Result<u64>::Err(os::get_error());
-    if (ret == 0) return Result<u64>::Err(os::Error::UnexpectedEof);
+        cnt += u64(ret);
+    } while (cnt < size);
 
-    return Result<u64>::Ok(u64(ret));
+    return Result<u64>::Ok(cnt);
 }
 
 #pragma endregion
@@ -347,7 +378,7 @@ pub fn Stream::read(void* data, u64 size) noexcept -> Result<u64> {
 
     // read from file
     if (rem_cnt >= $buf_size) {
-        _file->read(rem_dat, rem_cnt).map([=](u64 x) { return x + (size - rem_cnt); });
+        return _file->read(rem_dat, rem_cnt).map([=](u64 x) { return x + (size - rem_cnt); });
     }
 
     // read from buf 
@@ -355,7 +386,7 @@ pub fn Stream::read(void* data, u64 size) noexcept -> Result<u64> {
     if (_rbuf.is_empty()) {
         let res = _file->read(_rbuf._data, _rbuf._capacity);
         if (res.is_err()) return res;
-        _rbuf._size = u32(res._ok);
+        _rbuf._size = usize(res._ok);
     }
 
     return this->read(rem_dat, rem_cnt).map([=](u64 x) { return x + (size - rem_cnt);  });
@@ -374,9 +405,13 @@ pub fn Stream::read_str() noexcept -> Result<String> {
     let file_size = _file->size();
     if (file_size == 0) { return Result<String>::Ok(); }
 
-    let cnt = u32(file_size + 3) / 4 * 4;
-    mut res = String::with_capacity(cnt);
-    return read_str(res).map([&](u32) -> String {return as_mov(res); });
+    let cnt = (file_size + 3) / 4 * 4;
+    if (cnt > usize(-1)) {
+        return Result<String>::Err(os::Error::InvalidData);
+    }
+
+    mut res = String::with_capacity(usize(cnt));
+    return read_str(res).map([&](u64) -> String {return as_mov(res); });
 }
 
 
@@ -403,14 +438,22 @@ pub fn load_str(Path path) -> Result<String> {
 
     mut& file     = file_opt._ok;
     let  file_len = file.size();
-    mut  read_str = String::with_capacity(file_len);
+    if (file_len > usize(-1)) {
+        return Result<String>::Err(os::Error::InvalidData);   // build with USTD_SIZE64=1
+    }
 
-    let  read_res = file.read(read_str._data, read_str._capacity);
-    if (read_res.is_err()) {
-        return Result<String>::Err(read_res._err);
+    mut read_str = String::with_capacity(usize(file_len));
+    mut read_len = u64(0);
+    while (read_len < file_len) {
+        let read_res = file.read(read_str._data + read_len, file_len - read_len);
+        if (read_res.is_err()) {
+            if (read_res._err == os::Error::UnexpectedEof) break;
+            return Result<String>::Err(read_res._err);
+        }
+        read_len += read_res._ok;
     }
 
-    read_str._size = read_res._ok;
+    read_str._size = usize(read_len);
     return Result<String>::Ok(as_mov(read_str));
 }
 
@@ -24,6 +24,7 @@ enum class FileMode
 {
     Open,
     Create,
+    Edit,   // read and write, the content is kept
 };
 
 pub fn to_str(FileMode mode) noexcept -> str;
@@ -78,6 +79,9 @@ public:
     // ctor
     static pub fn open(Path path) noexcept->Result<File>;
 
+    // ctor: open for read and write, the content is kept
+    static pub fn edit(Path path) noexcept->Result<File>;
+
     // property[r]: is_valid
     pub fn is_valid() const noexcept;
 
@@ -104,7 +108,7 @@ protected:
     pub File(Path path, Mode mode, Type type) noexcept;
 
     // ctor: open for read
-    static pub fn open_impl(Path path, Type type) noexcept -> Result<File>;
+    static pub fn open_impl(Path path, Type type, Mode mode = Mode::Open) noexcept -> Result<File>;
 
     // ctor: create for write
     static pub fn create_impl(Path path, Type type) noexcept -> Result<File>;
@@ -133,6 +137,13 @@ public:
         return res;
     }
 
+    template<char ...C, class ...U>
+    fn write_fmt(FmtStr<C...> fmt, const U& ...u) noexcept -> Result<u64> {
+        let text    = sformat(fmt, u...);
+        let res     = write_str(text);
+        return res;
+    }
+
     template<class ...U>
     static fn sformat(str fmt, const U& ...u) noexcept -> str {
         mut& sbuf = get_strbuf();
@@ -142,6 +153,15 @@ public:
         return res;
     }
 
+    template<char ...C, class ...U>
+    static fn sformat(FmtStr<C...> fmt, const U& ...u) noexcept -> str {
+        mut& sbuf = get_strbuf();
+
+        sbuf.clear();
+        let res = ustd::sformat(sbuf, fmt, u...);
+        return res;
+    }
+
 protected:
     pub TxtFile(File&& other) noexcept;
 
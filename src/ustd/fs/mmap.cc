@@ -0,0 +1,304 @@
+#include "config.inl"
+
+namespace ustd::fs
+{
+
+#pragma region enums
+pub fn to_str(MmapMode mode) noexcept -> str {
+    switch (mode) {
+        case MmapMode::Read:    return "Read";
+        case MmapMode::Write:   return "Write";
+        case MmapMode::Copy:    return "Copy";
+    }
+    return "";
+}
+
+pub fn to_str(MmapAdvice advice) noexcept -> str {
+    switch (advice) {
+        case MmapAdvice::Normal:        return "Normal";
+        case MmapAdvice::Sequential:    return "Sequential";
+        case MmapAdvice::Random:        return "Random";
+        case MmapAdvice::WillNeed:      return "WillNeed";
+    }
+    return "";
+}
+#pragma endregion
+
+#pragma region MmapFile
+#if defined(MAP_FAILED)
+static fn page_size() noexcept -> u64 {
+    static let res = u64(::sysconf(_SC_PAGESIZE));
+    return res;
+}
+
+// `len` bytes of `fid` on a huge page boundary: reserve one huge page more, map the file over it, trim the rest
+static fn map_huge(u64 len, i32 prot, i32 flag, i32 fid) noexcept -> void* {
+    let page = $mem_huge_page;
+    let resv = ::mmap(nullptr, len + page, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (resv == MAP_FAILED) {
+        return MAP_FAILED;
+    }
+
+    let beg = (u64(resv) + page - 1) & ~(page - 1);
+    let end = u64(resv) + len + page;
+    let res = ::mmap(reinterpret_cast<void*>(beg), len, prot, flag | MAP_FIXED, fid, 0);
+    if (res == MAP_FAILED) {
+        ::munmap(resv, len + page);
+        return MAP_FAILED;
+    }
+
+    if (beg != u64(resv)) ::munmap(resv, beg - u64(resv));
+    if (beg + len != end) ::munmap(reinterpret_cast<void*>(beg + len), end - beg - len);
+
+#if defined(MADV_HUGEPAGE)
+    ::madvise(res, len, MADV_HUGEPAGE);
+#endif
+    return res;
+}
+#endif
+
+pub MmapFile::MmapFile(File&& file, Mode mode, bool huge) noexcept
+    : _file(as_mov(file)), _mode(mode), _huge(huge), _data(nullptr), _size(0), _map(0)
+{}
+
+pub MmapFile::MmapFile(MmapFile&& other) noexcept
+    : _file(as_mov(other._file)), _mode(other._mode), _huge(other._huge), _data(other._data), _size(other._size), _map(other._map)
+{
+    other._data = nullptr;
+    other._size = 0;
+    other._map  = 0;
+}
+
+pub MmapFile::~MmapFile() noexcept {
+    unmap();
+}
+
+pub fn MmapFile::open(Path path, Mode mode, bool huge) noexcept -> Result<MmapFile> {
+    mut file = mode == Mode::Write ? File::edit(path) : File::open(path);
+    if (file.is_err()) {
+        return Result<MmapFile>::Err(file._err);
+    }
+
+    mut res  = MmapFile(as_mov(file._ok), mode, huge);
+    let stat = res.map(res._file.size());
+    if (stat.is_err()) {
+        return Result<MmapFile>::Err(stat._err);
+    }
+    return Result<MmapFile>::Ok(as_mov(res));
+}
+
+pub fn MmapFile::create(Path path, u64 size, bool huge) noexcept -> Result<MmapFile> {
+    mut file = File::create(path);
+    if (file.is_err()) {
+        return Result<MmapFile>::Err(file._err);
+    }
+
+    mut res  = MmapFile(as_mov(file._ok), Mode::Write, huge);
+    let stat = res.resize(size);
+    if (stat.is_err()) {
+        return Result<MmapFile>::Err(stat._err);
+    }
+    return Result<MmapFile>::Ok(as_mov(res));
+}
+
+pub fn MmapFile::map(u64 size) noexcept -> Result<none_t> {
+    _size = size;
+    if (size == 0) {
+        return Result<none_t>::Ok();
+    }
+    if (size > usize(-1)) {
+        log::error("ustd::fs::MmapFile[fid={}].map(size={}) -> Error(`size exceeds usize, build with USTD_SIZE64=1`)", i32(_file._fid), size);
+        return Result<none_t>::Err(os::Error::InvalidData);
+    }
+
+#if defined(MAP_FAILED)
+    let len  = (size + page_size() - 1) & ~(page_size() - 1);
+    let prot = _mode == Mode::Read ? PROT_READ : PROT_READ | PROT_WRITE;
+    let flag = _mode == Mode::Copy ? MAP_PRIVATE : MAP_SHARED;
+    let fid  = i32(_file._fid);
+
+    mut res = MAP_FAILED;
+    if (_huge && len >= $mem_huge_page) {
+        res = map_huge(len, prot, flag, fid);
+    }
+    if (res == MAP_FAILED) {
+        res = ::mmap(nullptr, len, prot, flag, fid, 0);
+    }
+    if (res == MAP_FAILED) {
+        let eid = os::get_error();
+        log::error("ustd::fs::MmapFile[fid={}].map(size={}, mode={}) -> Error(`{}`)", fid, size, _mode, eid);
+        _size = 0;
+        return Result<none_t>::Err(eid);
+    }
+
+    _data = static_cast<u8*>(res);
+    _map  = len;
+    return Result<none_t>::Ok();
+#else
+    log::error("ustd::fs::MmapFile[fid={}].map(size={}) -> Error(`mmap is not available`)", i32(_file._fid), size);
+    _size = 0;
+    return Result<none_t>::Err(os::Error::Other);
+#endif
+}
+
+pub fn MmapFile::unmap() noexcept -> void {
+#if defined(MAP_FAILED)
+    if (_data != nullptr) {
+        ::munmap(_data, _map);
+    }
+#endif
+    _data = nullptr;
+    _map  = 0;
+}
+
+pub fn MmapFile::advise(Advice advice, u64 offset, u64 len) noexcept -> Result<none_t> {
+    if (_data == nullptr || offset >= _map) {
+        return Result<none_t>::Ok();
+    }
+
+#if defined(MAP_FAILED)
+    let beg = offset & ~(page_size() - 1);
+    let cnt = len == 0 || offset + len > _map ? _map - beg : offset + len - beg;
+    let val =
+        advice == Advice::Sequential ? MADV_SEQUENTIAL :
+        advice == Advice::Random     ? MADV_RANDOM :
+        advice == Advice::WillNeed   ? MADV_WILLNEED : MADV_NORMAL;
+
+    if (::madvise(_data + beg, cnt, val) != 0) {
+        let eid = os::get_error();
+        log::warn("ustd::fs::MmapFile[fid={}].advise(advice={}, offset={}, len={}) -> Error(`{}`)", i32(_file._fid), advice, offset, len, eid);
+        return Result<none_t>::Err(eid);
+    }
+#endif
+    return Result<none_t>::Ok();
+}
+
+pub fn MmapFile::resize(u64 size) noexcept -> Result<none_t> {
+    if (_mode != Mode::Write) {
+        log::error("ustd::fs::MmapFile[fid={}].resize(size={}) -> Error(`mode is {}, not Write`)", i32(_file._fid), size, _mode);
+        return Result<none_t>::Err(os::Error::InvalidInput);
+    }
+
+#if defined(MAP_FAILED)
+    if (::ftruncate(i32(_file._fid), off_t(size)) != 0) {
+        let eid = os::get_error();
+        log::error("ustd::fs::MmapFile[fid={}].resize(size={}) -> Error(`{}`)", i32(_file._fid), size, eid);
+        return Result<none_t>::Err(eid);
+    }
+
+#if defined(MREMAP_MAYMOVE)
+    // grow or shrink in place where the address space allows, the pages stay mapped
+    let len = (size + page_size() - 1) & ~(page_size() - 1);
+    if (_data != nullptr && len != 0 && !_huge && size <= usize(-1)) {
+        let res = ::mremap(_data, _map, len, MREMAP_MAYMOVE);
+        if (res != MAP_FAILED) {
+            _data = static_cast<u8*>(res);
+            _size = size;
+            _map  = len;
+            return Result<none_t>::Ok();
+        }
+    }
+#endif
+#endif
+
+    unmap();
+    return map(size);
+}
+
+pub fn MmapFile::sync() noexcept -> Result<none_t> {
+    if (_data == nullptr || _mode != Mode::Write) {
+        return Result<none_t>::Ok();
+    }
+
+#if defined(MAP_FAILED)
+    if (::msync(_data, _map, MS_SYNC) != 0) {
+        let eid = os::get_error();
+        log::error("ustd::fs::MmapFile[fid={}].sync() -> Error(`{}`)", i32(_file._fid), eid);
+        return Result<none_t>::Err(eid);
+    }
+#endif
+    return Result<none_t>::Ok();
+}
+#pragma endregion
+
+unittest(MmapFile) {
+    let path = Path("ustd_fs_mmap_test.bin");
+
+    // write, grow past a page, the content stays
+    {
+        mut file = MmapFile::create(path, 5000).unwrap();
+        mut data = file.bytes_mut();
+        for (mut i = 0u; i < 5000; ++i) {
+            data[i] = u8(i * 7);
+        }
+
+        assert_eq(file.resize(12000).is_ok(), true);
+        data = file.bytes_mut();
+        assert_eq(file.size(), u64(12000));
+        assert_eq(data[4999], u8(4999 * 7));
+        assert_eq(data[11999], u8(0));
+        data[11999] = u8(1);
+        assert_eq(file.sync().is_ok(), true);
+    }
+
+    // copy on write, stores stay private
+    {
+        mut file = MmapFile::open(path, MmapMode::Copy).unwrap();
+        file.bytes_mut()[0] = u8(0xFF);
+    }
+
+    mut file = MmapFile::open(path).unwrap();
+    assert_eq(file.advise(MmapAdvice::Sequential).is_ok(), true);
+    let data = file.bytes();
+    assert_eq(data._size, usize(12000));
+    assert_eq(data[0], u8(0));
+    assert_eq(data[4999], u8(4999 * 7));
+    assert_eq(data[11999], u8(1));
+    assert_eq(file.bytes_mut()._size, usize(0));
+
+    // the same bytes as a read
+    let text = load_str(path).unwrap();
+    assert_eq(__builtin_memcmp(text._data, file.as_str()._data, 12000), 0);
+
+    remove_file(path);
+}
+
+unittest(MmapFile_perf) {
+    let path = Path("ustd_fs_mmap_perf.bin");
+    let size = u64(64) << 20;
+    {
+        mut file = MmapFile::create(path, size).unwrap();
+        mut data = file.bytes_mut();
+        for (mut i = usize(0); i < data._size; i += 64) {
+            data[i] = u8(i >> 6);
+        }
+    }
+
+    let t0 = time::Instant::now();
+    mut sum0 = u64(0);
+    {
+        let text = load_str(path).unwrap();
+        for (mut i = usize(0); i < text._size; i += 64) {
+            sum0 += u8(text[i]);
+        }
+    }
+    let t1 = time::Instant::now();
+    mut sum1 = u64(0);
+    {
+        mut file = MmapFile::open(path).unwrap();
+        file.advise(MmapAdvice::Sequential);
+        let data = file.bytes();
+        for (mut i = usize(0); i < data._size; i += 64) {
+            sum1 += data[i];
+        }
+    }
+    let t2 = time::Instant::now();
+
+    assert_eq(sum0, sum1);
+    remove_file(path);
+
+    let mb = f64(size >> 20);
+    log::info("ustd::fs::MmapFile: load_str={}MB/s, mmap={}MB/s", u64(mb / (t1 - t0).total_secs()), u64(mb / (t2 - t1).total_secs()));
+}
+
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "ustd/core.h"
+#include "ustd/fs/file.h"
+
+namespace ustd::fs
+{
+
+enum class MmapMode
+{
+    Read,   // read only
+    Write,  // read and write, stores reach the file
+    Copy,   // read and write, copy on write, stores stay private
+};
+
+pub fn to_str(MmapMode mode) noexcept -> str;
+
+// MmapAdvice: expected access pattern, see madvise
+enum class MmapAdvice
+{
+    Normal,
+    Sequential,
+    Random,
+    WillNeed,
+};
+
+pub fn to_str(MmapAdvice advice) noexcept -> str;
+
+// MmapFile: a file mapped into memory, its content without copies
+//  - `bytes` and `as_str` view the mapping, they are valid until the file is resized or dropped
+//  - huge: the mapping starts on a huge page boundary and asks for transparent huge pages
+//  - files larger than 4GB need 64 bit lengths, build with USTD_SIZE64=1
+class MmapFile
+{
+public:
+    using Mode   = MmapMode;
+    using Advice = MmapAdvice;
+
+    File    _file;
+    Mode    _mode;
+    bool    _huge;
+    u8*     _data;
+    u64     _size;      // bytes of the file
+    u64     _map;       // bytes mapped, whole pages
+
+    pub MmapFile(MmapFile&& other) noexcept;
+    pub ~MmapFile() noexcept;
+
+    // ctor: map an existing file
+    static pub fn open(Path path, Mode mode = Mode::Read, bool huge = false) noexcept -> Result<MmapFile>;
+
+    // ctor: create or truncate `path` to `size` bytes, mapped for write
+    static pub fn create(Path path, u64 size, bool huge = false) noexcept -> Result<MmapFile>;
+
+    // property[r]: size
+    fn size() const noexcept -> u64 {
+        return _size;
+    }
+
+    // property[r]: bytes
+    fn bytes() const noexcept -> Slice<const u8> {
+        return { _data, usize(_size) };
+    }
+
+    // property[r]: bytes, `Write` and `Copy` mappings
+    fn bytes_mut() noexcept -> Slice<u8> {
+        return { _mode == Mode::Read ? nullptr : _data, _mode == Mode::Read ? 0 : usize(_size) };
+    }
+
+    // property[r]: as_str
+    fn as_str() const noexcept -> str {
+        return { reinterpret_cast<const char*>(_data), usize(_size) };
+    }
+
+    // method: advise, `len` 0: to the end
+    pub fn advise(Advice advice, u64 offset = 0, u64 len = 0) noexcept -> Result<none_t>;
+
+    // method: resize, `Write` mappings: set the file size and map it again, the data may move
+    pub fn resize(u64 size) noexcept -> Result<none_t>;
+
+    // method: sync, write dirty pages of a `Write` mapping to the file
+    pub fn sync() noexcept -> Result<none_t>;
+
+protected:
+    pub MmapFile(File&& file, Mode mode, bool huge) noexcept;
+
+    pub fn map(u64 size) noexcept -> Result<none_t>;
+    pub fn unmap() noexcept -> void;
+};
+
+}
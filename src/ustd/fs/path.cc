@@ -211,8 +211,9 @@ pub fn current_exe() noexcept -> Path {
 #endif
 
 #ifdef USTD_OS_MACOS
-    res._size = res._capacity;
-    _NSGetExecutablePath(res._data, &res._size);
+    mut len = u32(res._capacity);
+    _NSGetExecutablePath(res._data, &len);
+    res._size = len;
 #endif
 
 #ifdef USTD_OS_LINUX
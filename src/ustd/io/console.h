@@ -114,6 +114,14 @@ public:
         return write_str(sbuf);
     }
 
+    template<char ...C, class ...Ts>
+    fn write_fmt(FmtStr<C...> fmt, const Ts& ...ts) const noexcept -> u32 {
+        mut& sbuf = get_sbuf();
+        sbuf.clear();
+        sformat(sbuf, fmt, ts...);
+        return write_str(sbuf);
+    }
+
     template<class ...U>
     fn writeln(str fmt, const U& ...args) const noexcept -> u32 {
         mut& sbuf = get_sbuf();
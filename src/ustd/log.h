@@ -1,3 +1,4 @@
 #pragma once
 
 #include "ustd/log/logger.h"
+#include "ustd/log/sink.h"
@@ -45,22 +45,374 @@ static fn to_title(Level level) noexcept -> str {
     return res;;
 }
 
+// console and file lines, the same on the calling thread and in the writer
+constexpr static let $console_fmt = "{}[{}]\x1b[0m {}{}\x1b[{}G\x1b[36m{>12.3}\x1b[0m\x1b[0G\n"_fmt;
+constexpr static let $file_fmt    = "{>12.3} [{}] {}\n"_fmt;
+
+#pragma region async
+// Record: header of a message in a LogRing, followed by title and body
+struct Record
+{
+    u32     _size;          // header and text, rounded up to 8, `$wrap`: continue at the ring start
+    u32     _body_len;
+    u8      _title_len;
+    i8      _title_sgr;
+    i8      _body_sgr;
+    u8      _pad;
+    u32     _fmt_id;        // `$text`: body is text, else the captured arguments of a binary call
+    f64     _time;
+};
+
+// LogRing: byte queue of one logging thread
+//  - single producer: the thread that owns it, single consumer: whoever holds `AsyncLog::_drain_mtx`
+//  - rings are never freed, a ring released by an exited thread is reused by the next new thread
+struct LogRing
+{
+    constexpr static let $capacity = u64(256 * 1024);   // power of 2
+    constexpr static let $wrap     = ~u32(0);
+    constexpr static let $text     = ~u32(0);
+    constexpr static let $max_text = $capacity / 4 - sizeof(Record);
+
+    u64         _head;      // atomic, written by the producer
+    u32         _busy;      // atomic, 1 while the producer pushes, `set_async(false)` waits for 0
+    u8          _pad0[52];
+    u64         _tail;      // atomic, written by the consumer
+    u8          _pad1[56];
+    u64         _dropped;   // atomic
+    u32         _owned;     // atomic, 1 while a thread logs into it
+    LogRing*    _next;
+    u8*         _data;
+
+    LogRing() noexcept
+        : _head(0), _busy(0), _pad0(), _tail(0), _pad1(), _dropped(0), _owned(1), _next(nullptr), _data(mnew<u8>($capacity))
+    {}
+
+    // rings of the logger are never dropped, this frees the ones of tests
+    ~LogRing() noexcept {
+        mdel(_data);
+    }
+
+    fn used() const noexcept -> u64 {
+        return sync::load(&_head, sync::Ordering::Relaxed) - sync::load(&_tail, sync::Ordering::Relaxed);
+    }
+
+    // false when full
+    fn push(Record rec, str title, str body) noexcept -> bool {
+        let size = (u64(sizeof(Record)) + title._size + body._size + 7) & ~u64(7);
+        let head = sync::load(&_head, sync::Ordering::Relaxed);
+        let tail = sync::load(&_tail, sync::Ordering::Acquire);
+        let off  = head & ($capacity - 1);
+        let skip = $capacity - off < size ? $capacity - off : 0;
+        if (head + skip + size - tail > $capacity) {
+            return false;
+        }
+
+        if (skip != 0) {
+            reinterpret_cast<Record*>(_data + off)->_size = $wrap;
+        }
+        let p = _data + ((head + skip) & ($capacity - 1));
+        rec._size = u32(size);
+        __builtin_memcpy(p, &rec, sizeof(Record));
+        __builtin_memcpy(p + sizeof(Record), title._data, title._size);
+        __builtin_memcpy(p + sizeof(Record) + title._size, body._data, body._size);
+        sync::store(&_head, head + skip + size, sync::Ordering::Release);
+        return true;
+    }
+
+    // f(record, title, body) for every queued message, returns the count
+    template<class F>
+    fn drain(F&& f) noexcept -> u32 {
+        mut cnt  = 0u;
+        mut tail = sync::load(&_tail, sync::Ordering::Relaxed);
+        let head = sync::load(&_head, sync::Ordering::Acquire);
+        while (tail != head) {
+            let off = tail & ($capacity - 1);
+            let rec = reinterpret_cast<const Record*>(_data + off);
+            if (rec->_size == $wrap) {
+                tail += $capacity - off;
+                continue;
+            }
+
+            let text = reinterpret_cast<const char*>(rec + 1);
+            f(*rec, str{ text, rec->_title_len }, str{ text + rec->_title_len, rec->_body_len });
+            tail += rec->_size;
+            cnt  += 1;
+        }
+        sync::store(&_tail, tail, sync::Ordering::Release);
+        return cnt;
+    }
+};
+
+// binary call sites, one decoder per `"..."_fmt` and argument types
+constexpr static let $bin_formats = 16384u;
+static _BinDecode bin_decode[$bin_formats];
+static u32        bin_count = 0;     // atomic
+
+static thread_local bool tls_sync = false;    // log calls of this thread are written synchronously
+
+struct RingSlot
+{
+    LogRing* _ring = nullptr;
+
+    // dead after this: log calls from thread_local dtors that run later are written synchronously,
+    //  a ring claimed by them would never be released
+    ~RingSlot() noexcept {
+        tls_sync = true;
+        if (_ring == nullptr) return;
+        sync::store(&_ring->_owned, 0u, sync::Ordering::Release);
+        _ring = nullptr;
+    }
+};
+
+static thread_local RingSlot tls_ring;
+
+// f(FileSink&) under `_file_mtx`, skipped without a file
+//  fs reports errors through the logger: calls from inside a sink skip the file instead of locking it again
+template<class F>
+static fn with_file(Logger& logger, F&& f) noexcept -> void {
+    if (FileSink::is_busy()) {
+        return;
+    }
+
+    mut guard = logger._file_mtx.lock().unwrap();
+    if (logger._file_opt.is_some()) {
+        f(logger._file_opt._val);
+    }
+}
+
+static AsyncLog* async_log = nullptr;   // atomic, set once the writer state exists
+
+struct AsyncLog
+{
+    constexpr static let $batch_size = u32(1024 * 1024);
+    constexpr static let $max_line   = u32(LogRing::$capacity / 4 + 256);
+    constexpr static let $idle_ms    = 10u;
+
+    LogRing*                        _rings;     // atomic, lock free list
+    u32                             _overflow;  // atomic, Overflow
+    bool                            _stop;      // atomic
+    u64                             _reported;  // dropped messages already reported
+    sync::Mutex                     _drain_mtx;
+    sync::Mutex                     _wake_mtx;
+    sync::CondVar                   _wake_cnd;
+    String                          _console_buf;
+    String                          _file_buf;
+    String                          _text_buf;  // decoded binary messages
+    List<thread::JoinHandle<void>>  _writer;
+
+    AsyncLog() noexcept
+        : _rings(nullptr), _overflow(u32(Overflow::Block)), _stop(false), _reported(0)
+        , _console_buf(String::with_capacity($batch_size))
+        , _file_buf(String::with_capacity($batch_size))
+        , _text_buf(String::with_capacity(LogRing::$capacity / 4))
+        , _writer(List<thread::JoinHandle<void>>::with_capacity(1))
+    {}
+
+    // never destroyed, the logger flushes through it at exit
+    static fn instance() noexcept -> AsyncLog& {
+        static let res = [] {
+            let heap = Arena::Scope(nullptr);
+            let ptr  = mnew<AsyncLog>(1);
+            ustd::ctor(ptr);
+            sync::store(&async_log, ptr, sync::Ordering::Release);
+            return ptr;
+        }();
+        return *res;
+    }
+
+    fn ring() noexcept -> LogRing* {
+        if (tls_ring._ring != nullptr) {
+            return tls_ring._ring;
+        }
+
+        for (mut r = sync::load(&_rings, sync::Ordering::Acquire); r != nullptr; r = r->_next) {
+            if (sync::compare_exchange(&r->_owned, 0u, 1u, sync::Ordering::Acquire)) {
+                tls_ring._ring = r;
+                return r;
+            }
+        }
+
+        let heap = Arena::Scope(nullptr);
+        let ring = mnew<LogRing>(1);
+        ustd::ctor(ring);
+        do {
+            ring->_next = sync::load(&_rings, sync::Ordering::Acquire);
+        } while (!sync::compare_exchange(&_rings, ring->_next, ring, sync::Ordering::AcqRel));
+
+        tls_ring._ring = ring;
+        return ring;
+    }
+
+    fn dropped() const noexcept -> u64 {
+        mut res = u64(0);
+        for (mut r = sync::load(&_rings, sync::Ordering::Acquire); r != nullptr; r = r->_next) {
+            res += sync::load(&r->_dropped, sync::Ordering::Relaxed);
+        }
+        return res;
+    }
+
+    // false when async is being turned off, the caller writes synchronously
+    fn push(io::SGR title_sgr, str title, io::SGR body_sgr, str body, f64 time, u32 fmt_id = LogRing::$text) noexcept -> bool {
+        let ring = this->ring();
+
+        // pairs with the fence in `quiesce`: either we see `_stop`, or it waits for this push
+        sync::store(&ring->_busy, 1u, sync::Ordering::Relaxed);
+        sync::fence(sync::Ordering::SeqCst);
+        if (sync::load(&_stop, sync::Ordering::Relaxed)) {
+            sync::store(&ring->_busy, 0u, sync::Ordering::Release);
+            return false;
+        }
+
+        title._size = title._size < 255 ? title._size : 255;
+        body._size  = body._size < LogRing::$max_text - title._size ? body._size : LogRing::$max_text - title._size;
+
+        mut rec = Record{};
+        rec._body_len  = u32(body._size);
+        rec._title_len = u8(title._size);
+        rec._title_sgr = i8(title_sgr);
+        rec._body_sgr  = i8(body_sgr);
+        rec._time      = time;
+        rec._fmt_id    = fmt_id;
+
+        while (!ring->push(rec, title, body)) {
+            if (Overflow(sync::load(&_overflow, sync::Ordering::Relaxed)) != Overflow::Block) {
+                sync::fetch_and_add(&ring->_dropped, u64(1));
+                sync::store(&ring->_busy, 0u, sync::Ordering::Release);
+                return true;
+            }
+            wake();
+            thread::yield();
+        }
+
+        sync::store(&ring->_busy, 0u, sync::Ordering::Release);
+
+        // wake the writer early when it falls behind
+        if (ring->used() > LogRing::$capacity / 2) {
+            wake();
+        }
+        return true;
+    }
+
+    // after `_stop`: wait until pushes that missed it are queued, draining so blocked ones get room
+    fn quiesce(Logger& logger) noexcept -> void {
+        sync::fence(sync::Ordering::SeqCst);
+        while (true) {
+            mut busy = false;
+            for (mut r = sync::load(&_rings, sync::Ordering::Acquire); r != nullptr; r = r->_next) {
+                busy |= sync::load(&r->_busy, sync::Ordering::Acquire) != 0;
+            }
+            if (!busy) break;
+
+            drain(logger);
+            thread::yield();
+        }
+    }
+
+    // the condvar logs at trace level, that must not queue again
+    fn wake() noexcept -> void {
+        let prev = tls_sync;
+        tls_sync = true;
+        _wake_cnd.notify_one();
+        tls_sync = prev;
+    }
+
+    fn write_out(Logger& logger) noexcept -> void {
+        if (!_console_buf.is_empty()) {
+            mut lock = io::stdout().lock();
+            lock.write_str(_console_buf);
+            _console_buf.clear();
+        }
+        if (!_file_buf.is_empty()) {
+            with_file(logger, [&](FileSink& sink) {
+                sink.write(_file_buf);
+            });
+            _file_buf.clear();
+        }
+    }
+
+    fn write_line(u32 columns, io::SGR title_sgr, str title, io::SGR body_sgr, str body, f64 time, bool tty, bool file) noexcept -> void {
+        if (tty)  sformat(_console_buf, $console_fmt, title_sgr, title, body_sgr, body, (columns - 12), time);
+        if (file) sformat(_file_buf, $file_fmt, time, title, body);
+    }
+
+    // one consumer at a time: the writer thread or a flushing caller
+    fn drain(Logger& logger) noexcept -> u32 {
+        mut guard = _drain_mtx.lock().unwrap();
+        let prev  = tls_sync;
+        tls_sync  = true;
+
+        let tty     = io::stdout().is_tty();
+        let columns = tty ? io::stdout().get_columns() : 0u;
+
+        mut file = false;
+        with_file(logger, [&](FileSink&) {
+            file = true;
+        });
+
+        mut cnt = 0u;
+        for (mut r = sync::load(&_rings, sync::Ordering::Acquire); r != nullptr; r = r->_next) {
+            cnt += r->drain([&](const Record& rec, str title, str body) {
+                if (rec._fmt_id != LogRing::$text) {
+                    _text_buf.clear();
+                    bin_decode[rec._fmt_id](_text_buf, reinterpret_cast<const u8*>(body._data));
+                    body = _text_buf;
+                }
+                write_line(columns, io::SGR(rec._title_sgr), title, io::SGR(rec._body_sgr), body, rec._time, tty, file);
+                if (_console_buf._size + $max_line > $batch_size || _file_buf._size + $max_line > $batch_size) {
+                    write_out(logger);
+                }
+            });
+        }
+
+        let dropped = this->dropped();
+        if (Overflow(sync::load(&_overflow, sync::Ordering::Relaxed)) == Overflow::Count && dropped != _reported) {
+            mut body = FixedStr<64>();
+            sformat(body, "ustd::log: {} messages dropped"_fmt, dropped - _reported);
+            write_line(columns, io::SGR::FG_YEL, "??", io::SGR::RST, body, time::Instant::now().total_secs(), tty, file);
+            _reported = dropped;
+        }
+
+        write_out(logger);
+        if (cnt != 0 && file) {
+            with_file(logger, [](FileSink& sink) {
+                sink.flush();
+            });
+        }
+        tls_sync = prev;
+        return cnt;
+    }
+
+    fn run(Logger& logger) noexcept -> void {
+        tls_sync = true;
+        while (!sync::load(&_stop, sync::Ordering::Acquire)) {
+            if (drain(logger) != 0) {
+                continue;
+            }
+            mut guard = _wake_mtx.lock().unwrap();
+            _wake_cnd.wait_timeout_ms(guard, $idle_ms);
+        }
+        drain(logger);
+    }
+};
+#pragma endregion
+
 pub Logger::Logger() noexcept
-    : _level(Level::Debug)
+    : _level(u32(Level::Debug)), _async(nullptr), _binary(false)
 {
     let level_str = env::var("ustd_log_level");
     let level_val = str_parse<Level>(level_str);
 
     if (level_val.is_some()) {
-        _level = level_val._val;
+        _level = u32(level_val._val);
     }
 }
 
 pub Logger::~Logger() noexcept {
+    set_async(false);
 }
 
 pub Logger::Logger(Logger&& other) noexcept
-    : _level(other._level)
+    : _level(u32(other.level())), _async(nullptr), _binary(false)
 {}
 
 // 64 KB
@@ -74,9 +426,91 @@ pub fn Logger::instance() noexcept -> Logger& {
     return res;
 }
 
-pub fn Logger::set_path(fs::Path path) noexcept -> void {
-    mut file = fs::TxtFile::create(path).ok();
-    ustd::swap(_file_opt, file);
+pub fn Logger::set_path(fs::Path path, Rotation rotation) noexcept -> void {
+    mut file = FileSink::create(path, rotation).ok();
+    {
+        mut guard = _file_mtx.lock().unwrap();
+        ustd::swap(_file_opt, file);
+    }
+    // the old sink flushes and closes outside the lock
+}
+
+pub fn Logger::set_async(bool enable, Overflow overflow) noexcept -> void {
+    let current = sync::load(&_async, sync::Ordering::Acquire);
+    if (!enable && current == nullptr) {
+        return;
+    }
+
+    mut& async = AsyncLog::instance();
+    sync::store(&async._overflow, u32(overflow), sync::Ordering::Relaxed);
+    if (enable == (current != nullptr)) {
+        return;
+    }
+
+    if (enable) {
+        sync::store(&async._stop, false, sync::Ordering::Release);
+        mut thr = thread::Builder().set_name("ustd::log::writer").spawn([this, &async]() {
+            async.run(*this);
+        });
+        async._writer.push(as_mov(thr));
+        sync::store(&_async, &async, sync::Ordering::Release);
+    }
+    else {
+        sync::store(&_async, static_cast<AsyncLog*>(nullptr), sync::Ordering::Release);
+        sync::store(&async._stop, true, sync::Ordering::Release);
+        async.quiesce(*this);
+        async.wake();
+        for (mut& thr : async._writer.into_iter()) {
+            thr.join();
+        }
+        async._writer.clear();
+        async.drain(*this);
+    }
+}
+
+pub fn Logger::set_binary(bool enable) noexcept -> void {
+    sync::store(&_binary, enable, sync::Ordering::Relaxed);
+}
+
+pub fn Logger::dropped() const noexcept -> u64 {
+    let async = sync::load(&async_log, sync::Ordering::Acquire);
+    return async == nullptr ? u64(0) : async->dropped();
+}
+
+pub fn Logger::flush() noexcept -> void {
+    let async = sync::load(&_async, sync::Ordering::Acquire);
+    if (async != nullptr && !tls_sync) {
+        async->drain(*this);
+    }
+    with_file(*this, [](FileSink& sink) {
+        sink.flush();
+    });
+}
+
+pub fn _bin_register(_BinDecode decode) noexcept -> u32 {
+    let id = sync::fetch_and_add(&bin_count, 1u);
+    if (id >= $bin_formats) {
+        return ~0u;
+    }
+    bin_decode[id] = decode;
+    return id;
+}
+
+pub fn Logger::log_args(Level level, u32 id, str args) noexcept -> bool {
+    let async = sync::load(&_async, sync::Ordering::Acquire);
+    if (async == nullptr || tls_sync || args._size > LogRing::$max_text - 8) {
+        return false;
+    }
+
+    let time_secs = time::Instant::now().total_secs();
+    if (!async->push(to_sgr(level), to_title(level), io::SGR::RST, args, time_secs, id)) {
+        return false;
+    }
+
+    if (level == Level::Fatal) {
+        flush();
+    }
+    return true;
 }
 
 pub fn Logger::log_msg(Level level, str text) noexcept -> void {
@@ -85,21 +519,32 @@ pub fn Logger::log_msg(Level level, str text) noexcept -> void {
     let body_sgr    = io::SGR::RST;
     let body_text   = text;
     log_msg(title_sgr, title_text, body_sgr, body_text);
+
+    // nothing queued is lost if the process dies next
+    if (level == Level::Fatal) {
+        flush();
+    }
 }
 
 pub fn Logger::log_msg(io::SGR title_sgr, str title_text, io::SGR body_sgr, str body_text) noexcept -> void {
     let  time_point = time::Instant::now();
     let  time_secs = time_point.total_secs();
 
+    // the writer thread logs synchronously, it can not wait for itself
+    let async = sync::load(&_async, sync::Ordering::Acquire);
+    if (async != nullptr && !tls_sync && async->push(title_sgr, title_text, body_sgr, body_text, time_secs)) {
+        return;
+    }
+
     if (io::stdout().is_tty()) {
         let columns         = io::stdout().get_columns();
         mut stdout_lock    = io::stdout().lock();
-        stdout_lock.write_fmt("{}[{}]\x1b[0m {}{}\x1b[{}G\x1b[36m{>12.3}\x1b[0m\x1b[0G\n", title_sgr, title_text, body_sgr, body_text, (columns - 12), time_secs);
+        stdout_lock.write_fmt($console_fmt, title_sgr, title_text, body_sgr, body_text, (columns - 12), time_secs);
     }
 
-    if (_file_opt.is_some()) {
-        _file_opt._val.write_fmt("{>12.3} [{}] {}", time_secs, title_text, body_text);
-    }
+    with_file(*this, [&](FileSink& sink) {
+        sink.write(fs::TxtFile::sformat($file_fmt, time_secs, title_text, body_text));
+    });
 }
 
 ustd_test(console_color) {
@@ -111,4 +556,133 @@ ustd_test(console_color) {
     log::fatal("fatal");
 }
 
+unittest(log_level) {
+    mut& log  = logger();
+    let  prev = log.level();
+    log.set_level(Level::Error);
+    assert_eq(log.enabled(Level::Warn), false);
+    assert_eq(log.enabled(Level::Fatal), true);
+
+    // lazy arguments
+    mut evals = 0u;
+    let count = [&]() { evals += 1; return evals; };
+    ustd_log(Debug, "ustd::log: not evaluated {}", count());
+    assert_eq(evals, 0u);
+    ustd_log(Error, "ustd::log: evaluated {}", count());
+    assert_eq(evals, 1u);
+
+    // disabled calls
+    let cnt = 1u << 24;
+    let t0  = time::Instant::now();
+    for (mut i = 0u; i < cnt; ++i) {
+        log::debug("ustd::log: disabled {} {}", i, &log);
+    }
+    let t1 = time::Instant::now();
+
+    log.set_level(prev);
+    log::info("ustd::log: disabled call={}ns", f64((t1 - t0).total_nanos()) / cnt);
+}
+
+unittest(log_ring) {
+    mut ring = LogRing();
+
+    // a producer thread against a consumer, across many wraps
+    let cnt = 100000u;
+    mut thr = thread::spawn([&]() {
+        mut body = FixedStr<64>();
+        for (mut i = 0u; i < cnt; ++i) {
+            body._size = 0;
+            sformat(body, "message {}", i);
+            mut rec = Record{};
+            rec._title_len = 2;
+            rec._body_len  = u32(body._size);
+            while (!ring.push(rec, "::", body)) {
+                thread::yield();
+            }
+        }
+    });
+
+    mut next = 0u;
+    mut fail = 0u;
+    while (next < cnt) {
+        ring.drain([&](const Record& rec, str title, str body) {
+            mut expect = FixedStr<64>();
+            sformat(expect, "message {}", next);
+            fail += (title == str("::") && body == str(expect) && rec._body_len == body._size) ? 0u : 1u;
+            next += 1;
+        });
+    }
+    thr.join();
+    assert_eq(fail, 0u);
+    assert_eq(ring.used(), u64(0));
+}
+
+unittest(log_ring_perf) {
+    mut ring = LogRing();
+    let body = str("ustd::log: a message of typical length, about sixty bytes");
+    mut rec  = Record{};
+    rec._title_len = 2;
+    rec._body_len  = u32(body._size);
+
+    let cnt = 1u << 20;
+    mut ns  = u64(0);
+    for (mut i = 0u; i < cnt; ) {
+        let t0 = time::Instant::now();
+        while (i < cnt && ring.push(rec, "::", body)) ++i;
+        let t1 = time::Instant::now();
+        ns += (t1 - t0).total_nanos();
+        ring.drain([](const Record&, str, str) {});
+    }
+    log::info("ustd::log::LogRing: push={}ns per message", ns / cnt);
+}
+
+unittest(log_binary) {
+    using fmt_t = decltype("id={} px={} qty={>8} side={} ok={} venue={} note={}"_fmt);
+    let venue = str("XNAS");
+    let ptr   = static_cast<const char*>("cstr");
+
+    mut text = FixedStr<256>();
+    sformat(text, fmt_t{}, 42u, 101.25, i64(-7), Level::Warn, true, venue, ptr);
+
+    mut args = FixedStr<256>();
+    assert_eq(_bin_encode(args, 42u, 101.25, i64(-7), Level::Warn, true, venue, ptr), true);
+
+    mut back = FixedStr<256>();
+    _bin_decode<fmt_t, u32, f64, i64, Level, bool, str, const char*>(back, reinterpret_cast<const u8*>(args._data));
+    assert_eq(str(back), str(text));
+
+    // string literals and strings
+    mut s = String::with_capacity(16);
+    s.push_slice(str("owned"));
+    text.clear();
+    sformat(text, "{} {}"_fmt, "bin", s);
+    args.clear();
+    _bin_encode(args, "bin", s);
+    back.clear();
+    _bin_decode<decltype("{} {}"_fmt), char[4], String>(back, reinterpret_cast<const u8*>(args._data));
+    assert_eq(str(back), str(text));
+
+    mut small = FixedStr<8>();
+    assert_eq(_bin_encode(small, str("longer than eight")), false);
+}
+
+unittest(log_binary_perf) {
+    let cnt = 1u << 20;
+    mut buf = FixedStr<256>();
+
+    let t0 = time::Instant::now();
+    for (mut i = 0u; i < cnt; ++i) {
+        buf.clear();
+        sformat(buf, "order {} px={} qty={}"_fmt, i, 101.25 + i, i64(i) * 100);
+    }
+    let t1 = time::Instant::now();
+    for (mut i = 0u; i < cnt; ++i) {
+        _bin_encode(buf, i, 101.25 + i, i64(i) * 100);
+    }
+    let t2 = time::Instant::now();
+
+    log::info("ustd::log: sformat={}ns, binary capture={}ns per message",
+        (t1 - t0).total_nanos() / cnt, (t2 - t1).total_nanos() / cnt);
+}
+
 }
@@ -3,6 +3,13 @@
 #include "ustd/core.h"
 #include "ustd/io.h"
 #include "ustd/fs.h"
+#include "ustd/sync/atomic.h"
+#include "ustd/log/sink.h"
+
+/* USTD_LOG_LEVEL: log calls below this level are compiled out, 0: trace, 1: debug, ... 5: fatal */
+#ifndef USTD_LOG_LEVEL
+#   define USTD_LOG_LEVEL 0
+#endif
 
 namespace ustd::log
 {
@@ -19,11 +26,136 @@ enum Level
 
 pub fn to_str(Level level) noexcept -> str;
 
+// lowest level that is compiled in, see USTD_LOG_LEVEL
+constexpr static let $min_level = Level(USTD_LOG_LEVEL);
+
+// Overflow: what an async log call does when the queue of its thread is full
+enum class Overflow
+{
+    Block,  // wait for the writer thread
+    Drop,   // drop the message
+    Count,  // drop the message, the writer reports how many were dropped
+};
+
+struct AsyncLog;
+
+#pragma region binary
+// _BinArg: how a log argument is captured in binary mode
+//  - numbers, bool, enums and pointers: their bytes
+//  - strings: length and bytes, decoded as `str`
+//  - other types are not captured, calls with them format text as usual
+template<class T, class = void>
+struct _BinArg
+{
+    constexpr static let $ok = false;
+};
+
+template<class T>
+struct _BinArg<T, when<(trait<T>::$num || trait<T>::$enum || trait<T>::$ptr) && !$is_same<T, const char*> && !$is_same<T, char*>>>
+{
+    constexpr static let $ok = true;
+
+    static fn size(const T&) noexcept -> usize {
+        return sizeof(T);
+    }
+
+    static fn write(u8* p, const T& val) noexcept -> u8* {
+        __builtin_memcpy(p, &val, sizeof(T));
+        return p + sizeof(T);
+    }
+
+    static fn read(const u8*& p) noexcept -> T {
+        mut res = T{};
+        __builtin_memcpy(&res, p, sizeof(T));
+        p += sizeof(T);
+        return res;
+    }
+};
+
+struct _BinStr
+{
+    constexpr static let $ok = true;
+
+    static fn size(str s) noexcept -> usize {
+        return sizeof(u32) + s._size;
+    }
+
+    static fn write(u8* p, str s) noexcept -> u8* {
+        let len = u32(s._size);
+        __builtin_memcpy(p, &len, sizeof(u32));
+        __builtin_memcpy(p + sizeof(u32), s._data, s._size);
+        return p + sizeof(u32) + s._size;
+    }
+
+    static fn read(const u8*& p) noexcept -> str {
+        mut len = u32(0);
+        __builtin_memcpy(&len, p, sizeof(u32));
+        let res = str{ reinterpret_cast<const char*>(p + sizeof(u32)), len };
+        p += sizeof(u32) + len;
+        return res;
+    }
+};
+
+template<class T>
+struct _BinArg<T, when<$is_base<Slice<char>, T> || $is_base<Slice<const char>, T>>> : _BinStr
+{};
+
+template<u32 N>
+struct _BinArg<char[N]> : _BinStr
+{};
+
+template<>
+struct _BinArg<const char*> : _BinStr
+{
+    static fn size(const char* s) noexcept -> usize { return _BinStr::size(cstr(s)); }
+    static fn write(u8* p, const char* s) noexcept -> u8* { return _BinStr::write(p, cstr(s)); }
+};
+
+template<>
+struct _BinArg<char*> : _BinArg<const char*>
+{};
+
+// _BinDecode: formats the captured arguments of one call site
+using _BinDecode = void(*)(StrView& outbuf, const u8* args);
+
+template<class F, class ...U, u32 ...I>
+fn _bin_format(StrView& outbuf, const u8* p, immut_t<u32, I...>) noexcept -> void {
+    ((_sformat_chunk<F, I>(outbuf), Formatter(F::$split._styles[I], outbuf)(_BinArg<U>::read(p))), ...);
+    _sformat_chunk<F, u32(sizeof...(I))>(outbuf);
+}
+
+// the same text as `sformat(outbuf, F{}, args...)`
+template<class F, class ...U>
+fn _bin_decode(StrView& outbuf, const u8* args) noexcept -> void {
+    _bin_format<F, U...>(outbuf, args, seq_t<u32(sizeof...(U))>{});
+}
+
+// false: `outbuf` is too small
+template<class ...U>
+fn _bin_encode(StrView& outbuf, const U& ...args) noexcept -> bool {
+    let size = (usize(0) + ... + _BinArg<U>::size(args));
+    if (size > outbuf._capacity) {
+        return false;
+    }
+
+    mut p = reinterpret_cast<u8*>(outbuf._data);
+    ((p = _BinArg<U>::write(p, args)), ...);
+    outbuf._size = size;
+    return true;
+}
+
+// id of a call site format, `~0u`: no ids left
+pub fn _bin_register(_BinDecode decode) noexcept -> u32;
+#pragma endregion
+
 class Logger
 {
 public:
-    Level               _level;
-    Option<fs::TxtFile> _file_opt;
+    u32                 _level;     // atomic, Level
+    Option<FileSink>    _file_opt;  // guarded by `_file_mtx`, `set_path` swaps it under running writers
+    sync::Mutex         _file_mtx;
+    AsyncLog*           _async;     // atomic, null: messages are written on the calling thread
+    bool                _binary;    // atomic
 
     pub Logger()  noexcept;
     pub ~Logger() noexcept;
@@ -31,26 +163,62 @@ public:
 
     static pub fn instance() noexcept -> Logger&;
 
+    // property[r]: level
     fn level() const noexcept -> Level {
-        return _level;
+        return Level(sync::load(&_level, sync::Ordering::Relaxed));
+    }
+
+    // property[w]: level
+    fn set_level(Level level) noexcept -> void {
+        sync::store(&_level, u32(level), sync::Ordering::Relaxed);
+    }
+
+    // method: enabled, one relaxed load, constant false below `$min_level`
+    fn enabled(Level level) const noexcept -> bool {
+        return level >= $min_level && u32(level) >= sync::load(&_level, sync::Ordering::Relaxed);
     }
 
-    // property[w]: path
-    pub fn set_path(fs::Path path) noexcept -> void;
+    // property[w]: path, messages are buffered and reach the file within `FileSink::$flush_secs`, see `FileSink`
+    pub fn set_path(fs::Path path, Rotation rotation = {}) noexcept -> void;
+
+    // property[w]: async
+    //  - log calls format on the caller and queue the text in a ring owned by their thread, no lock and no syscall
+    //  - one writer thread drains every ring and writes console and file in large batches
+    //  - order is kept per thread; fatal messages and `flush` wait until everything queued is written
+    pub fn set_async(bool enable, Overflow overflow = Overflow::Block) noexcept -> void;
+
+    // property[w]: binary
+    //  - async log calls with a `"..."_fmt` format queue its id and the raw argument bytes, no formatting
+    //  - the writer thread formats them, the text is the same as in text mode
+    //  - calls with arguments other than numbers, bool, enums, pointers and strings still format on the caller
+    pub fn set_binary(bool enable) noexcept -> void;
 
-    template<class ...U> void trace(str fmt, const U& ...args) noexcept { log_fmt(Level::Trace, fmt, args...); }
-    template<class ...U> void debug(str fmt, const U& ...args) noexcept { log_fmt(Level::Debug, fmt, args...); }
-    template<class ...U> void info (str fmt, const U& ...args) noexcept { log_fmt(Level::Info,  fmt, args...); }
-    template<class ...U> void warn (str fmt, const U& ...args) noexcept { log_fmt(Level::Warn,  fmt, args...); }
-    template<class ...U> void error(str fmt, const U& ...args) noexcept { log_fmt(Level::Error, fmt, args...); }
-    template<class ...U> void fatal(str fmt, const U& ...args) noexcept { log_fmt(Level::Fatal, fmt, args...); }
+    // property[r]: number of messages dropped by full queues
+    pub fn dropped() const noexcept -> u64;
+
+    // method: flush, write every queued message before returning
+    pub fn flush() noexcept -> void;
+
+    template<class ...U> void trace(str fmt, const U& ...args) noexcept { if constexpr (Level::Trace >= $min_level) log_fmt(Level::Trace, fmt, args...); }
+    template<class ...U> void debug(str fmt, const U& ...args) noexcept { if constexpr (Level::Debug >= $min_level) log_fmt(Level::Debug, fmt, args...); }
+    template<class ...U> void info (str fmt, const U& ...args) noexcept { if constexpr (Level::Info >= $min_level) log_fmt(Level::Info,  fmt, args...); }
+    template<class ...U> void warn (str fmt, const U& ...args) noexcept { if constexpr (Level::Warn >= $min_level) log_fmt(Level::Warn,  fmt, args...); }
+    template<class ...U> void error(str fmt, const U& ...args) noexcept { if constexpr (Level::Error >= $min_level) log_fmt(Level::Error, fmt, args...); }
+    template<class ...U> void fatal(str fmt, const U& ...args) noexcept { if constexpr (Level::Fatal >= $min_level) log_fmt(Level::Fatal, fmt, args...); }
+
+    template<char ...C, class ...U> void trace(FmtStr<C...> fmt, const U& ...args) noexcept { if constexpr (Level::Trace >= $min_level) log_fmt(Level::Trace, fmt, args...); }
+    template<char ...C, class ...U> void debug(FmtStr<C...> fmt, const U& ...args) noexcept { if constexpr (Level::Debug >= $min_level) log_fmt(Level::Debug, fmt, args...); }
+    template<char ...C, class ...U> void info (FmtStr<C...> fmt, const U& ...args) noexcept { if constexpr (Level::Info >= $min_level) log_fmt(Level::Info,  fmt, args...); }
+    template<char ...C, class ...U> void warn (FmtStr<C...> fmt, const U& ...args) noexcept { if constexpr (Level::Warn >= $min_level) log_fmt(Level::Warn,  fmt, args...); }
+    template<char ...C, class ...U> void error(FmtStr<C...> fmt, const U& ...args) noexcept { if constexpr (Level::Error >= $min_level) log_fmt(Level::Error, fmt, args...); }
+    template<char ...C, class ...U> void fatal(FmtStr<C...> fmt, const U& ...args) noexcept { if constexpr (Level::Fatal >= $min_level) log_fmt(Level::Fatal, fmt, args...); }
 
     pub fn log_msg(Level lvel, str text) noexcept -> void;
     pub fn log_msg(io::SGR title_sgr, str title, io::SGR body_sgr, str body_text) noexcept -> void;
 
     template<class ...U>
     fn log_fmt(Level level, str fmt, const U& ...args) noexcept -> void {
-        if (level < _level) {
+        if (!enabled(level)) {
             return;
         }
         mut& sbuf = get_sbuf();
@@ -59,6 +227,22 @@ public:
         log_msg(level, sbuf);
     }
 
+    template<char ...C, class ...U>
+    fn log_fmt(Level level, FmtStr<C...> fmt, const U& ...args) noexcept -> void {
+        if (!enabled(level)) {
+            return;
+        }
+        if constexpr ((_BinArg<U>::$ok && ...)) {
+            if (sync::load(&_binary, sync::Ordering::Relaxed) && log_bin(level, fmt, args...)) {
+                return;
+            }
+        }
+        mut& sbuf = get_sbuf();
+        sbuf.clear();
+        ustd::sformat(sbuf, fmt, args...);
+        log_msg(level, sbuf);
+    }
+
     template<class ...U>
     fn log_fmt(io::SGR title_sgr, str title_text, io::SGR body_sgr, str fmt, const U& ...args) noexcept -> void {
         mut& sbuf = get_sbuf();
@@ -67,6 +251,23 @@ public:
         log_msg(title_sgr, title_text, body_sgr, sbuf);
     }
 
+    // false: not queued, the caller formats text
+    template<char ...C, class ...U>
+    fn log_bin(Level level, FmtStr<C...>, const U& ...args) noexcept -> bool {
+        static let id = _bin_register(&_bin_decode<FmtStr<C...>, U...>);
+        if (id == ~0u) {
+            return false;
+        }
+
+        mut& sbuf = get_sbuf();
+        if (!_bin_encode(sbuf, args...)) {
+            return false;
+        }
+        return log_args(level, id, sbuf);
+    }
+
+    pub fn log_args(Level level, u32 id, str args) noexcept -> bool;
+
 private:
     // 64 KB
     static pub fn get_sbuf() noexcept->StrView&;
@@ -76,11 +277,29 @@ inline fn logger() noexcept -> Logger& {
     return Logger::instance();
 }
 
-template<class ...U> fn trace(str fmt, const U& ...args) noexcept -> void { logger().trace(fmt, args...); }
-template<class ...U> fn debug(str fmt, const U& ...args) noexcept -> void { logger().debug(fmt, args...); }
-template<class ...U> fn info (str fmt, const U& ...args) noexcept -> void { logger().info (fmt, args...); }
-template<class ...U> fn warn (str fmt, const U& ...args) noexcept -> void { logger().warn (fmt, args...); }
-template<class ...U> fn error(str fmt, const U& ...args) noexcept -> void { logger().error(fmt, args...); }
-template<class ...U> fn fatal(str fmt, const U& ...args) noexcept -> void { logger().fatal(fmt, args...); }
+template<class ...U> fn trace(str fmt, const U& ...args) noexcept -> void { if constexpr (Level::Trace >= $min_level) logger().trace(fmt, args...); }
+template<class ...U> fn debug(str fmt, const U& ...args) noexcept -> void { if constexpr (Level::Debug >= $min_level) logger().debug(fmt, args...); }
+template<class ...U> fn info (str fmt, const U& ...args) noexcept -> void { if constexpr (Level::Info >= $min_level) logger().info (fmt, args...); }
+template<class ...U> fn warn (str fmt, const U& ...args) noexcept -> void { if constexpr (Level::Warn >= $min_level) logger().warn (fmt, args...); }
+template<class ...U> fn error(str fmt, const U& ...args) noexcept -> void { if constexpr (Level::Error >= $min_level) logger().error(fmt, args...); }
+template<class ...U> fn fatal(str fmt, const U& ...args) noexcept -> void { if constexpr (Level::Fatal >= $min_level) logger().fatal(fmt, args...); }
+
+template<char ...C, class ...U> fn trace(FmtStr<C...> fmt, const U& ...args) noexcept -> void { if constexpr (Level::Trace >= $min_level) logger().trace(fmt, args...); }
+template<char ...C, class ...U> fn debug(FmtStr<C...> fmt, const U& ...args) noexcept -> void { if constexpr (Level::Debug >= $min_level) logger().debug(fmt, args...); }
+template<char ...C, class ...U> fn info (FmtStr<C...> fmt, const U& ...args) noexcept -> void { if constexpr (Level::Info >= $min_level) logger().info (fmt, args...); }
+template<char ...C, class ...U> fn warn (FmtStr<C...> fmt, const U& ...args) noexcept -> void { if constexpr (Level::Warn >= $min_level) logger().warn (fmt, args...); }
+template<char ...C, class ...U> fn error(FmtStr<C...> fmt, const U& ...args) noexcept -> void { if constexpr (Level::Error >= $min_level) logger().error(fmt, args...); }
+template<char ...C, class ...U> fn fatal(FmtStr<C...> fmt, const U& ...args) noexcept -> void { if constexpr (Level::Fatal >= $min_level) logger().fatal(fmt, args...); }
 
 }
+
+// ustd_log: `ustd_log(Trace, "x={}", expensive())`, the arguments are evaluated only when the level is enabled
+//  - below USTD_LOG_LEVEL the call, its arguments included, is compiled out
+#define ustd_log(level, ...)                                                                \
+    do {                                                                                    \
+        if constexpr (ustd::log::Level::level >= ustd::log::$min_level) {                   \
+            if (ustd::log::logger().enabled(ustd::log::Level::level)) {                     \
+                ustd::log::logger().log_fmt(ustd::log::Level::level, __VA_ARGS__);          \
+            }                                                                               \
+        }                                                                                   \
+    } while (0)
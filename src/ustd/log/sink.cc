@@ -0,0 +1,274 @@
+#include "config.inl"
+
+namespace ustd::log
+{
+
+// fs logs through the logger: messages raised inside the sink skip the file instead of locking it again
+static thread_local bool tls_busy = false;
+
+pub FileSink::FileSink(fs::Path path, Rotation rotation, fs::File&& file) noexcept
+    : _path(path)
+    , _rotation(rotation)
+    , _mtx()
+    , _cnd()
+    , _file(as_mov(file))
+    , _stream(fs::Stream::from_file(_file))
+    , _size(0)
+    , _open_time(time::Instant::now().total_secs())
+    , _flush_time(_open_time)
+    , _dirty(false)
+    , _stop(false)
+    , _cleaner(List<thread::JoinHandle<void>>::with_capacity(1))
+    , _flusher(List<thread::JoinHandle<void>>::with_capacity(1))
+{}
+
+pub FileSink::FileSink(FileSink&& other) noexcept
+    : _path(other.stop_flusher()._path)     // the flusher of `other` is joined before its members move
+    , _rotation(other._rotation)
+    , _mtx(as_mov(other._mtx))
+    , _cnd(as_mov(other._cnd))
+    , _file(as_mov(other._file))
+    , _stream(as_mov(other._stream))
+    , _size(other._size)
+    , _open_time(other._open_time)
+    , _flush_time(other._flush_time)
+    , _dirty(other._dirty)
+    , _stop(false)
+    , _cleaner(as_mov(other._cleaner))
+    , _flusher(as_mov(other._flusher))
+{
+    _stream._file = &_file;
+}
+
+pub FileSink::~FileSink() noexcept {
+    stop_flusher();
+}
+
+pub fn FileSink::create(fs::Path path, Rotation rotation) noexcept -> fs::Result<FileSink> {
+    mut file = fs::File::create(path);
+    if (file.is_err()) {
+        return fs::Result<FileSink>::Err(file._err);
+    }
+    return fs::Result<FileSink>::Ok(FileSink(path, rotation, as_mov(file._ok)));
+}
+
+pub fn FileSink::is_busy() noexcept -> bool {
+    return tls_busy;
+}
+
+pub fn FileSink::write(str text) noexcept -> void {
+    if (text._size == 0 || tls_busy) {
+        return;
+    }
+
+    mut guard = _mtx.lock().unwrap();
+    tls_busy  = true;
+
+    let now = time::Instant::now().total_secs();
+    let full = _rotation._max_size != 0 && _size != 0 && _size + text._size > _rotation._max_size;
+    let old  = _rotation._interval != 0 && now - _open_time >= f64(_rotation._interval);
+    if (full || old) {
+        rotate_impl(now);
+    }
+
+    _stream.write(text._data, text._size);
+    _size  += text._size;
+    _dirty  = true;
+
+    if (now - _flush_time >= $flush_secs) {
+        _stream.flush();
+        _dirty      = false;
+        _flush_time = now;
+    }
+
+    // started here, not in the ctor: the sink is moved into place before its first write
+    if (_flusher._size == 0) {
+        mut thr = thread::Builder().set_name("ustd::log::flusher").spawn([this]() {
+            this->flush_loop();
+        });
+        _flusher.push(as_mov(thr));
+    }
+    tls_busy = false;
+}
+
+pub fn FileSink::flush() noexcept -> void {
+    if (tls_busy) {
+        return;
+    }
+
+    mut guard = _mtx.lock().unwrap();
+    tls_busy  = true;
+    _stream.flush();
+    _dirty      = false;
+    _flush_time = time::Instant::now().total_secs();
+    tls_busy  = false;
+}
+
+pub fn FileSink::rotate() noexcept -> void {
+    if (tls_busy) {
+        return;
+    }
+
+    mut guard = _mtx.lock().unwrap();
+    tls_busy  = true;
+    rotate_impl(time::Instant::now().total_secs());
+    tls_busy  = false;
+}
+
+pub fn FileSink::flush_loop() noexcept -> void {
+    tls_busy = true;
+
+    mut guard = _mtx.lock().unwrap();
+    while (!_stop) {
+        let now = time::Instant::now().total_secs();
+        let due = _flush_time + $flush_secs;
+        if (_dirty && now >= due) {
+            _stream.flush();
+            _dirty      = false;
+            _flush_time = now;
+        }
+
+        // a clean buffer waits a full period, a write in between is flushed on the next wake
+        let secs = _dirty ? ustd::max(due - now, 0.001) : $flush_secs;
+        _cnd.wait_timeout_ms(guard, u32(secs * 1000.0));
+    }
+}
+
+pub fn FileSink::stop_flusher() noexcept -> FileSink& {
+    if (_flusher._size == 0) {
+        return *this;
+    }
+
+    {
+        mut guard = _mtx.lock().unwrap();
+        _stop = true;
+        _cnd.notify_one();
+    }
+    for (mut& thr : _flusher.into_iter()) {
+        thr.join();
+    }
+    _flusher.clear();
+    _stop = false;
+    return *this;
+}
+
+pub fn FileSink::segment(u32 idx) const noexcept -> fs::FixedPath<> {
+    return idx == 0 ? fs::FixedPath<>::from_fmt("{}.del", _path) : fs::FixedPath<>::from_fmt("{}.{}", _path, idx);
+}
+
+pub fn FileSink::rotate_impl(f64 now) noexcept -> void {
+    _stream.flush();
+    _file.close();
+    _file._fid = fs::fid_t::Invalid;
+
+    // the previous cleaner is done with `path.del`
+    for (mut& thr : _cleaner.into_iter()) {
+        thr.join();
+    }
+    _cleaner.clear();
+
+    // path.{keep} -> path.del, path.{i} -> path.{i+1}, path -> path.1
+    let keep = _rotation._keep;
+    let del  = segment(0);
+    if (keep == 0) {
+        fs::rename(_path, del);
+    }
+    else {
+        let last = segment(keep);
+        if (last.is_exists()) {
+            fs::rename(last, del);
+        }
+        for (mut i = keep - 1; i != 0; --i) {
+            let src = segment(i);
+            if (src.is_exists()) {
+                fs::rename(src, segment(i + 1));
+            }
+        }
+        fs::rename(_path, segment(1));
+    }
+
+    // unlinking a large segment can block, it runs on its own thread
+    if (del.is_exists()) {
+        mut thr = thread::Builder().set_name("ustd::log::cleaner").spawn([del]() {
+            tls_busy = true;
+            fs::remove_file(del);
+        });
+        _cleaner.push(as_mov(thr));
+    }
+
+    mut next = fs::File::create(_path);
+    if (next.is_ok()) {
+        ustd::swap(_file, next._ok);
+    }
+    _stream._file = &_file;
+    _size         = 0;
+    _open_time    = now;
+    _flush_time   = now;
+    _dirty        = false;
+}
+
+unittest(FileSink) {
+    let path = fs::Path("ustd_log_sink_test.log");
+    mut sink = FileSink::create(path, Rotation{ 64, 0, 2 }).unwrap();
+
+    // 10 lines of 20 bytes, 3 lines per segment
+    for (mut i = 0u; i < 10; ++i) {
+        mut line = FixedStr<32>();
+        sformat(line, "ustd::log: line {>3}\n", i);
+        sink.write(line);
+    }
+    sink.flush();
+
+    assert_eq(fs::load_str(path).unwrap()._size, usize(20));
+    assert_eq(fs::load_str(sink.segment(1)).unwrap()._size, usize(60));
+    assert_eq(sink.segment(2).is_exists(), true);
+    assert_eq(sink.segment(3).is_exists(), false);
+
+    sink.rotate();
+    sink.flush();
+    for (mut& thr : sink._cleaner.into_iter()) {
+        thr.join();
+    }
+    assert_eq(sink.segment(0).is_exists(), false);
+
+    fs::remove_file(sink.segment(1));
+    fs::remove_file(sink.segment(2));
+    fs::remove_file(path);
+
+    // interval: a write after the interval starts a new file, one closed segment is kept
+    {
+        mut sink = FileSink::create(path, Rotation{ 0, 1, 1 }).unwrap();
+        for (mut i = 0u; i < 3; ++i) {
+            if (i != 0) {
+                thread::sleep_ms(1100);
+            }
+            mut line = FixedStr<32>();
+            sformat(line, "ustd::log: line {>3}\n", i);
+            sink.write(line);
+        }
+        sink.flush();
+        for (mut& thr : sink._cleaner.into_iter()) {
+            thr.join();
+        }
+
+        assert_eq(str(fs::load_str(path).unwrap()), str("ustd::log: line   2\n"));
+        assert_eq(str(fs::load_str(sink.segment(1)).unwrap()), str("ustd::log: line   1\n"));
+        assert_eq(sink.segment(2).is_exists(), false);
+        assert_eq(sink.segment(0).is_exists(), false);
+        fs::remove_file(sink.segment(1));
+    }
+    fs::remove_file(path);
+
+    // without a flush or another write, the flusher writes the last line out
+    {
+        mut idle = FileSink::create(path).unwrap();
+        idle.write("ustd::log: idle\n");
+        for (mut i = 0u; i < 30 && fs::load_str(path).unwrap()._size == 0; ++i) {
+            thread::sleep_ms(100);
+        }
+        assert_eq(fs::load_str(path).unwrap()._size, usize(16));
+    }
+    fs::remove_file(path);
+}
+
+}
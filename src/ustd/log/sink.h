@@ -0,0 +1,78 @@
+#pragma once
+
+#include "ustd/core.h"
+#include "ustd/fs.h"
+#include "ustd/sync/mutex.h"
+#include "ustd/sync/condvar.h"
+#include "ustd/thread/thread.h"
+
+namespace ustd::log
+{
+
+// Rotation: when the log file starts a new segment
+//  - the file keeps its path, closed segments are renamed to `path.1` (newest) ... `path.{keep}` (oldest)
+//  - segments beyond `_keep` are deleted by a background thread
+struct Rotation
+{
+    u64 _max_size = 0;  // bytes, 0: no limit
+    u64 _interval = 0;  // seconds, 0: no limit
+    u32 _keep     = 8;  // closed segments kept
+};
+
+// FileSink: buffered log file
+//  - text is appended to the 64KB buffer of a `fs::Stream`, a message costs no syscall
+//  - the buffer is written out when full, by `flush`, and by a flusher thread at most `$flush_secs`
+//    after the first unflushed message, so an idle process still gets its last lines on disk
+//  - the flusher starts with the first write and stops with the sink
+class FileSink
+{
+public:
+    constexpr static let $flush_secs = 1.0;
+
+    fs::FixedPath<> _path;
+    Rotation        _rotation;
+    sync::Mutex     _mtx;
+    sync::CondVar   _cnd;
+    fs::File        _file;
+    fs::Stream      _stream;
+    u64             _size;          // bytes in the current segment
+    f64             _open_time;
+    f64             _flush_time;
+    bool            _dirty;         // bytes buffered since the last flush
+    bool            _stop;
+
+    List<thread::JoinHandle<void>>  _cleaner;
+    List<thread::JoinHandle<void>>  _flusher;
+
+    pub FileSink(FileSink&& other) noexcept;
+    pub ~FileSink() noexcept;
+
+    // ctor: create `path`, truncated
+    static pub fn create(fs::Path path, Rotation rotation = {}) noexcept -> fs::Result<FileSink>;
+
+    // property[r]: the calling thread is inside a sink, the logger skips the file for its messages
+    static pub fn is_busy() noexcept -> bool;
+
+    // method: write, starts a new segment first when the current one is full or old
+    pub fn write(str text) noexcept -> void;
+
+    // method: flush
+    pub fn flush() noexcept -> void;
+
+    // method: rotate, close the current segment and start a new one
+    pub fn rotate() noexcept -> void;
+
+    // property[r]: path of a closed segment, `path.{idx}`, 0: `path.del`, the one being deleted
+    pub fn segment(u32 idx) const noexcept -> fs::FixedPath<>;
+
+protected:
+    pub FileSink(fs::Path path, Rotation rotation, fs::File&& file) noexcept;
+
+    pub fn rotate_impl(f64 now) noexcept -> void;
+    pub fn flush_loop() noexcept -> void;
+
+    // method: join the flusher, it points at `this`
+    pub fn stop_flusher() noexcept -> FileSink&;
+};
+
+}
@@ -6,4 +6,5 @@
 #include "ustd/math/expr.h"
 #include "ustd/math/vline.h"
 
-#include "ustd/math/blas.h"
\ No newline at end of file
+#include "ustd/math/blas.h"
+#include "ustd/math/fft.h"
\ No newline at end of file
@@ -33,7 +33,7 @@ static fn get_trans(NDSlice<T, 2> A) -> Trans {
 static fn _get_mkl() -> Option<ffi::Mod> {
     mut res = ffi::Mod::load("mkl_rt");
     if (res.is_none()) {
-        log::error("ustd::math::mkl::get_mkl(): cannot load library.");
+        log::warn("ustd::math::mkl::get_mkl(): cannot load library, use native kernels.");
     }
     return as_mov(res);
 }
@@ -63,13 +63,37 @@ static fn get_fun(str name) -> Option<ffi::Fn<F>> {
 
 }
 
+#pragma region backend
+static mut _backend = Backend::Auto;
+
+pub fn set_backend(Backend backend) noexcept -> void {
+    sync::store(&_backend, backend);
+}
+
+pub fn get_backend() noexcept -> Backend {
+    let backend = sync::load(&_backend, sync::Ordering::Relaxed);
+    if (backend != Backend::Auto) {
+        return backend;
+    }
+    return get_mkl().is_some() ? Backend::MKL : Backend::Native;
+}
+
+static fn use_mkl() noexcept -> bool {
+    return get_backend() == Backend::MKL;
+}
+#pragma endregion
+
 // blas: 1
 inline namespace blas
 {
 pub fn amax(vf32 x) noexcept-> u32 {
+    if (!use_mkl()) {
+        return native::amax(x);
+    }
+
     static let f = get_fun<u32(u32 cnt, f32* vx, u32 dx)>("cblas_isamax");
     if(f.is_none()) {
-        return 0;
+        return native::amax(x);
     }
 
     let cnt = x.count();
@@ -78,9 +102,13 @@ pub fn amax(vf32 x) noexcept-> u32 {
 }
 
 pub fn amax(vf64 x) noexcept-> u32 {
+    if (!use_mkl()) {
+        return native::amax(x);
+    }
+
     static let f = get_fun<u32(u32 cnt, f64* vx, u32 dx)>("cblas_idamax");
     if(f.is_none()) {
-        return 0;
+        return native::amax(x);
     }
 
     let cnt = x.count();
@@ -102,9 +130,13 @@ unittest(amax)
 }
 
 pub fn amin(vf32 x) noexcept -> u32 {
+    if (!use_mkl()) {
+        return native::amin(x);
+    }
+
     static let f = get_fun<u32(u32 cnt, f32* vx, u32 dx)>("cblas_isamin");
     if (f.is_none()) {
-        return 0;
+        return native::amin(x);
     }
 
     let cnt = x.count();
@@ -113,9 +145,13 @@ pub fn amin(vf32 x) noexcept -> u32 {
 }
 
 pub fn amin(vf64 x) noexcept -> u32 {
+    if (!use_mkl()) {
+        return native::amin(x);
+    }
+
     static let f = get_fun<u32(u32 cnt, f64* vx, u32 dx)>("cblas_idamin");
     if (f.is_none()) {
-        return 0;
+        return native::amin(x);
     }
 
     let cnt = x.count();
@@ -141,9 +177,13 @@ unittest(samin)
 }
 
 pub fn asum(vf32 x) noexcept->f32 {
+    if (!use_mkl()) {
+        return native::asum(x);
+    }
+
     static let f = get_fun<f32(u32 cnt, f32* vx, u32 dx)>("cblas_sasum");
     if (f.is_none()) {
-        return 0;
+        return native::asum(x);
     }
 
     let cnt = x.count();
@@ -152,9 +192,13 @@ pub fn asum(vf32 x) noexcept->f32 {
 }
 
 pub fn asum(vf64 x) noexcept->f64 {
+    if (!use_mkl()) {
+        return native::asum(x);
+    }
+
     static let f = get_fun<f64(u32 cnt, f64* vx, u32 dx)>("cblas_dasum");
     if (f.is_none()) {
-        return 0;
+        return native::asum(x);
     }
 
     let cnt = x.count();
@@ -163,9 +207,13 @@ pub fn asum(vf64 x) noexcept->f64 {
 }
 
 pub fn axpy(f32 alpha, vf32 x, vf32 y) -> void {
+    if (!use_mkl()) {
+        return native::axpy(alpha, x, y);
+    }
+
     static let f = get_fun<void(u32 cnt, f32 alpha, f32* vx, u32 dx, f32* vy, u32 dy)>("cblas_saxpy");
     if (f.is_none()) {
-        return;
+        return native::axpy(alpha, x, y);
     }
 
     let cnt = y.count();
@@ -173,9 +221,13 @@ pub fn axpy(f32 alpha, vf32 x, vf32 y) -> void {
 }
 
 pub fn axpy(f64 alpha, vf64 x, vf64 y) -> void {
+    if (!use_mkl()) {
+        return native::axpy(alpha, x, y);
+    }
+
     static let f = get_fun<void(u32 cnt, f64 alpha, f64* vx, u32 dx, f64* vy, u32 dy)>("cblas_daxpy");
     if (f.is_none()) {
-        return;
+        return native::axpy(alpha, x, y);
     }
 
     let cnt = x.count();
@@ -183,9 +235,13 @@ pub fn axpy(f64 alpha, vf64 x, vf64 y) -> void {
 }
 
 pub fn copy(vf32 x, vf32 y) -> void {
+    if (!use_mkl()) {
+        return native::copy(x, y);
+    }
+
     static let f = get_fun<void(u32 cnt, f32* vx, u32 dx, f32* vy, u32 dy)>("cblas_scopy");
     if (f.is_none()) {
-        return;
+        return native::copy(x, y);
     }
 
     let cnt = x.count();
@@ -193,9 +249,13 @@ pub fn copy(vf32 x, vf32 y) -> void {
 }
 
 pub fn copy(vf64 x, vf64 y) -> void {
+    if (!use_mkl()) {
+        return native::copy(x, y);
+    }
+
     static let f = get_fun<void(u32 cnt, f64* vx, u32 dx, f64* vy, u32 dy)>("cblas_dcopy");
     if (f.is_none()) {
-        return;
+        return native::copy(x, y);
     }
 
     let cnt = x.count();
@@ -203,9 +263,13 @@ pub fn copy(vf64 x, vf64 y) -> void {
 }
 
 pub fn dot(vf32 x, vf32 y) noexcept->f32 {
+    if (!use_mkl()) {
+        return native::dot(x, y);
+    }
+
     static let f = get_fun<f32(u32 cnt, f32* vx, u32 dx, f32* vy, u32 dy)>("cblas_sdot");
     if (f.is_none()) {
-        return 0;
+        return native::dot(x, y);
     }
 
     let cnt = x.count();
@@ -214,9 +278,13 @@ pub fn dot(vf32 x, vf32 y) noexcept->f32 {
 }
 
 pub fn dot(vf64 x, vf64 y) noexcept->f64 {
+    if (!use_mkl()) {
+        return native::dot(x, y);
+    }
+
     static let f = get_fun<f64(u32 cnt, f64* vx, u32 dx, f64* vy, u32 dy)>("cblas_ddot");
     if (f.is_none()) {
-        return 0;
+        return native::dot(x, y);
     }
 
     let cnt = x.count();
@@ -225,9 +293,13 @@ pub fn dot(vf64 x, vf64 y) noexcept->f64 {
 }
 
 pub fn nrm2(vf32 x) noexcept->f32 {
+    if (!use_mkl()) {
+        return native::nrm2(x);
+    }
+
     static let f = get_fun<f32(u32 cnt, f32* vx, u32 dx)>("cblas_snrm2");
     if (f.is_none()) {
-        return 0;
+        return native::nrm2(x);
     }
 
     let cnt = x.count();
@@ -236,9 +308,13 @@ pub fn nrm2(vf32 x) noexcept->f32 {
 }
 
 pub fn nrm2(vf64 x) noexcept->f64 {
+    if (!use_mkl()) {
+        return native::nrm2(x);
+    }
+
     static let f = get_fun<f64(u32 cnt, f64* vx, u32 dx)>("cblas_dnrm2");
     if (f.is_none()) {
-        return 0;
+        return native::nrm2(x);
     }
 
     let cnt = x.count();
@@ -247,10 +323,14 @@ pub fn nrm2(vf64 x) noexcept->f64 {
 }
 
 pub fn rot(vf32 x, vf32 y, f32x4 h) -> void {
+    if (!use_mkl()) {
+        return native::rot(x, y, h);
+    }
+
     static let f1 = get_fun<void(u32 cnt, f32* vx, u32 dx, f32* vy, u32 dy, f32 c, f32 s)>("cblas_srot");
     static let f2 = get_fun<void(u32 cnt, f32* vx, u32 dx, f32* vy, u32 dy, f32* m)>("cblas_srotm");
     if (f1.is_none() || f2.is_none()) {
-        return;
+        return native::rot(x, y, h);
     }
 
     let cnt = y.count();
@@ -267,10 +347,14 @@ pub fn rot(vf32 x, vf32 y, f32x4 h) -> void {
 }
 
 pub fn rot(vf64 x, vf64 y, f64x4 h) -> void {
-    static let f1 = get_fun<void(u32 cnt, f64* vx, u32 dx, f64* vy, u32 dy, f64 c, f64 s)>("cblas_srot");
-    static let f2 = get_fun<void(u32 cnt, f64* vx, u32 dx, f64* vy, u32 dy, f64* m)>("cblas_srotm");
+    if (!use_mkl()) {
+        return native::rot(x, y, h);
+    }
+
+    static let f1 = get_fun<void(u32 cnt, f64* vx, u32 dx, f64* vy, u32 dy, f64 c, f64 s)>("cblas_drot");
+    static let f2 = get_fun<void(u32 cnt, f64* vx, u32 dx, f64* vy, u32 dy, f64* m)>("cblas_drotm");
     if (f1.is_none() || f2.is_none()) {
-        return;
+        return native::rot(x, y, h);
     }
 
     let cnt = y.count();
@@ -303,9 +387,13 @@ unittest(rot)
 }
 
 pub fn scal(f32 alpha, vf32 x) -> void {
+    if (!use_mkl()) {
+        return native::scal(alpha, x);
+    }
+
     static let f = get_fun<void(u32 cnt, f32 alpha, f32* vx, u32 dx)>("cblas_sscal");
     if (f.is_none()) {
-        return;
+        return native::scal(alpha, x);
     }
 
     let cnt = x.count();
@@ -313,9 +401,13 @@ pub fn scal(f32 alpha, vf32 x) -> void {
 }
 
 pub fn scal(f64 alpha, vf64 x) -> void {
+    if (!use_mkl()) {
+        return native::scal(alpha, x);
+    }
+
     static let f = get_fun<void(u32 cnt, f64 alpha, f64* vx, u32 dx)>("cblas_dscal");
     if (f.is_none()) {
-        return;
+        return native::scal(alpha, x);
     }
     
     let cnt = x.count();
@@ -323,9 +415,13 @@ pub fn scal(f64 alpha, vf64 x) -> void {
 }
 
 pub fn swap(vf32 x, vf32 y) -> void {
+    if (!use_mkl()) {
+        return native::swap(x, y);
+    }
+
     static let f = get_fun<void(u32 cnt, f32* vx, u32 dx, f32* vy, u32 dy)>("cblas_sswap");
     if (f.is_none()) {
-        return;
+        return native::swap(x, y);
     }
 
     let cnt = y.count();
@@ -333,47 +429,87 @@ pub fn swap(vf32 x, vf32 y) -> void {
 }
 
 pub fn swap(vf64 x, vf64 y) -> void {
+    if (!use_mkl()) {
+        return native::swap(x, y);
+    }
+
     static let f = get_fun<void(u32 cnt, f64* vx, u32 dx, f64* vy, u32 dy)>("cblas_dswap");
+    if (f.is_none()) {
+        return native::swap(x, y);
+    }
+
     let cnt = y.count();
     f._val(cnt, x._data, x._step[0], y._data, y._step[0]);
 }
 
 // y := alpha*A*x + beta*y
 pub fn gemv(f32 alpha, mf32 A, vf32 x, f32 beta, vf32 y) -> void {
+    if (!use_mkl()) {
+        return native::gemv(alpha, A, x, beta, y);
+    }
+
     static let f = get_fun<void(Layout layout, Trans trans, u32 m, u32 n, f32 alpha, f32* ma, u32 lda, f32* vx, u32 incx, f32 beta, f32* vy, u32 incy)>("cblas_sgemv");
+    if (f.is_none()) {
+        return native::gemv(alpha, A, x, beta, y);
+    }
+
     let trans = get_trans(A);
-    f._val(Layout::Col, trans, A._dims[0], A._dims[1], alpha, A._data, A._step[1], x._data, x._step[0], beta, y._data, y._step[1]);
+    f._val(Layout::Col, trans, A._dims[0], A._dims[1], alpha, A._data, A._step[1], x._data, x._step[0], beta, y._data, y._step[0]);
 }
 
 // y := alpha*A*x + beta*y
 pub fn gemv(f64 alpha, mf64 ma, vf64 vx, f64 beta, vf64 vy) -> void {
+    if (!use_mkl()) {
+        return native::gemv(alpha, ma, vx, beta, vy);
+    }
+
     static let f = get_fun<void(Layout layout, Trans trans, u32 m, u32 n, f64 alpha, f64* ma, u32 lda, f64* vx, u32 incx, f64 beta, f64* vy, u32 incy)>("cblas_dgemv");
     if (f.is_none()) {
-        return;
+        return native::gemv(alpha, ma, vx, beta, vy);
     }
     
-    f._val(Layout::Col, get_trans(ma), ma._dims[0], ma._dims[1], alpha, ma._data, ma._step[1], vx._data, vx._step[0], beta, vy._data, vy._step[1]);
+    f._val(Layout::Col, get_trans(ma), ma._dims[0], ma._dims[1], alpha, ma._data, ma._step[1], vx._data, vx._step[0], beta, vy._data, vy._step[0]);
 }
 
 // A := alpha*x*y' + A
 pub fn ger(f32 alpha, vf32 x, vf32 y, mf32 A) -> void {
+    if (!use_mkl()) {
+        return native::ger(alpha, x, y, A);
+    }
+
     static let f = get_fun<void(Layout layout, Trans trans, u32 m, u32 n, f32 alpha, f32* vx, u32 incx, f32* vy, u32 incy, f32* ma, u32 lda)>("cblas_sger");
+    if (f.is_none()) {
+        return native::ger(alpha, x, y, A);
+    }
+
     let trans = get_trans(A);
     f._val(Layout::Col, trans, A._dims[0], A._dims[1], alpha, x._data, x._step[0], y._data, y._step[0], A._data, A._step[1]);
 }
 
 // A := alpha*x*y' + A
 pub fn ger(f64 alpha, vf64 vx, vf64 vy, mf64 A) -> void {
+    if (!use_mkl()) {
+        return native::ger(alpha, vx, vy, A);
+    }
+
     static let f = get_fun<void(Layout layout, Trans trans, u32 m, u32 n, f64 alpha, f64* vx, u32 incx, f64* vy, u32 incy, f64* ma, u32 lda)>("cblas_dger");
+    if (f.is_none()) {
+        return native::ger(alpha, vx, vy, A);
+    }
+
     let trans = get_trans(A);
     f._val(Layout::Col, trans, A._dims[0], A._dims[1], alpha, vx._data, vx._step[0], vy._data, vy._step[0], A._data, A._step[1]);
 }
 
 // C := alpha*A*B + beta*C
 pub fn gemm(f32 alpha, mf32 A, mf32 B, f32 beta, mf32 C) -> void {
+    if (!use_mkl()) {
+        return native::gemm(alpha, A, B, beta, C);
+    }
+
     static let f = get_fun<void(Layout layout, Trans transa, Trans transb, u32 m, u32 n, u32 k, f32 alpha, f32* a, u32 lda, f32* b, u32 ldb, f32 beta, f32* c, u32 ldc)>("cblas_sgemm");
     if (f.is_none()) {
-        return;
+        return native::gemm(alpha, A, B, beta, C);
     }
     
     let trans_a = get_trans(A);
@@ -383,9 +519,13 @@ pub fn gemm(f32 alpha, mf32 A, mf32 B, f32 beta, mf32 C) -> void {
 
 // C := alpha*A*B + beta*C
 pub fn gemm(f64 alpha, mf64 A, mf64 B, f64 beta, mf64 C) -> void {
+    if (!use_mkl()) {
+        return native::gemm(alpha, A, B, beta, C);
+    }
+
     static let f = get_fun<void(Layout layout, Trans transa, Trans transb, u32 m, u32 n, u32 k, f64 alpha, f64* a, u32 lda, f64* b, u32 ldb, f64 beta, f64* c, u32 ldc)>("cblas_dgemm");
     if (f.is_none()) {
-        return;
+        return native::gemm(alpha, A, B, beta, C);
     }
     
     f._val(Layout::Col, Trans::NoTrans, Trans::NoTrans, C._dims[0], C._dims[1], A._dims[1], alpha, A._data, A._step[1], B._data, B._step[1], beta, C._data, C._step[1]);
@@ -398,113 +538,187 @@ pub fn gemm(f64 alpha, mf64 A, mf64 B, f64 beta, mf64 C) -> void {
 inline namespace lapack
 {
 
+// LAPACKE wants dim 0 contiguous and 1-based pivots, `vp` is 0-based as in `native`
+template<class T>
+static fn use_lapacke(const NDSlice<T, 2>& A) noexcept -> bool {
+    return use_mkl() && A._step[0] == 1;
+}
+
+static fn shift_pivots(vu32& vp, u32 n, i32 delta) noexcept -> void {
+    for (mut i = 0u; i < n; ++i) {
+        vp(i) = u32(i32(vp(i)) + delta);
+    }
+}
+
 // A = P*L*U
-pub fn getrf(mf32 A, vu32 vp) -> void {
-    static let f = get_fun<void(Layout layout, u32 m, u32 n, f32* ma, u32 lda, u32* vp)>("cblas_sgetrf");
+pub fn getrf(mf32 A, vu32 vp) -> u32 {
+    if (!use_lapacke(A)) {
+        return native::getrf(A, vp);
+    }
+
+    static let f = get_fun<i32(Layout layout, u32 m, u32 n, f32* ma, u32 lda, u32* vp)>("LAPACKE_sgetrf");
     if (f.is_none()) {
-        return;
+        return native::getrf(A, vp);
     }
-    
-    f._val(Layout::Col, A._dims[0], A._dims[1], A._data, A._step[1], vp._data);
+
+    let info = f._val(Layout::Col, A._dims[0], A._dims[1], A._data, A._step[1], vp._data);
+    shift_pivots(vp, ustd::min(A._dims[0], A._dims[1]), -1);
+    return info > 0 ? u32(info) : 0u;
 }
 
 // A = P*L*U
-pub fn getrf(mf64 A, vu32 vp) -> void {
-    static let f = get_fun<void(Layout layout, u32 m, u32 n, f64* ma, u32 lda, u32* vp)>("cblas_dgetrf");
+pub fn getrf(mf64 A, vu32 vp) -> u32 {
+    if (!use_lapacke(A)) {
+        return native::getrf(A, vp);
+    }
+
+    static let f = get_fun<i32(Layout layout, u32 m, u32 n, f64* ma, u32 lda, u32* vp)>("LAPACKE_dgetrf");
     if (f.is_none()) {
-        return;
+        return native::getrf(A, vp);
     }
-    
-    f._val(Layout::Col, A._dims[0], A._dims[1], A._data, A._step[1], vp._data);
+
+    let info = f._val(Layout::Col, A._dims[0], A._dims[1], A._data, A._step[1], vp._data);
+    shift_pivots(vp, ustd::min(A._dims[0], A._dims[1]), -1);
+    return info > 0 ? u32(info) : 0u;
 }
 
 // A = QR
 pub fn geqrf(mf32 A, vf32 tau) -> void {
-    static let f = get_fun<void(Layout layout, u32 m, u32 n, f32* a, u32 lda, f32* tau)>("cblas_sgeqrf");
+    if (!use_lapacke(A)) {
+        return native::geqrf(A, tau);
+    }
+
+    static let f = get_fun<i32(Layout layout, u32 m, u32 n, f32* a, u32 lda, f32* tau)>("LAPACKE_sgeqrf");
     if (f.is_none()) {
-        return;
+        return native::geqrf(A, tau);
     }
-    
+
     f._val(Layout::Col, A._dims[0], A._dims[1], A._data, A._step[1], tau._data);
 }
 
 // A = QR
 pub fn geqrf(mf64 A, vf64 tau) -> void {
-    static let f = get_fun<void(Layout layout, u32 m, u32 n, f64* a, u32 lda, f64* tau)>("cblas_dgeqrf");
+    if (!use_lapacke(A)) {
+        return native::geqrf(A, tau);
+    }
+
+    static let f = get_fun<i32(Layout layout, u32 m, u32 n, f64* a, u32 lda, f64* tau)>("LAPACKE_dgeqrf");
     if (f.is_none()) {
-        return;
+        return native::geqrf(A, tau);
     }
-    
+
     f._val(Layout::Col, A._dims[0], A._dims[1], A._data, A._step[1], tau._data);
 }
 
 // SVD
-// A = U*E*Vt
+// A = U*E*Vt, MKL only
 pub fn gesvd(mf32 A, vf32 s, mf32 U, mf32 VT) -> void {
-    static let f = get_fun<i32(Layout layout, char jobu, char jobvt, u32 m, u32 n, f32* a, u32 lda, f32* s, f32* u, u32 ldu, f32* vt, u32 ldvt, f32* superb)>("LAPACKE_gesvd");
+    static let f = get_fun<i32(Layout layout, char jobu, char jobvt, u32 m, u32 n, f32* a, u32 lda, f32* s, f32* u, u32 ldu, f32* vt, u32 ldvt, f32* superb)>("LAPACKE_sgesvd");
     if (f.is_none()) {
+        log::error("ustd::math::lapack::gesvd(): no native kernel, needs `mkl_rt`");
         return;
     }
-    
+
+    mut superb = NDArray<f32>::with_dims({ ustd::max(ustd::min(A._dims[0], A._dims[1]), 2u) - 1 });
     let jobu  =  U.count() == 0 ? 'N' : 'A';
     let jobvt = VT.count() == 0 ? 'N' : 'A';
-    let info  = f._val(Layout::Col, jobu, jobvt, A._dims[0], A._dims[1], A._data, A._step[1], s._data, U._data, U._step[1], VT._data, VT._step[1], nullptr);
+    let info  = f._val(Layout::Col, jobu, jobvt, A._dims[0], A._dims[1], A._data, A._step[1], s._data, U._data, U._step[1], VT._data, VT._step[1], superb._data);
     (void)info;
 }
 
-// A -> A'
-pub fn getri(mf32 A, vu32 vp) -> void {
-    static let f = get_fun<void(Layout layout, u32 n, f32* ma, u32 lda, u32* vp)>("cblas_sgetri");
+// SVD
+// A = U*E*Vt, MKL only
+pub fn gesvd(mf64 A, vf64 s, mf64 U, mf64 VT) -> void {
+    static let f = get_fun<i32(Layout layout, char jobu, char jobvt, u32 m, u32 n, f64* a, u32 lda, f64* s, f64* u, u32 ldu, f64* vt, u32 ldvt, f64* superb)>("LAPACKE_dgesvd");
     if (f.is_none()) {
+        log::error("ustd::math::lapack::gesvd(): no native kernel, needs `mkl_rt`");
         return;
     }
-    
-    f._val(Layout::Col, A._dims[0], A._data, A._dims[0], vp._data);
+
+    mut superb = NDArray<f64>::with_dims({ ustd::max(ustd::min(A._dims[0], A._dims[1]), 2u) - 1 });
+    let jobu  =  U.count() == 0 ? 'N' : 'A';
+    let jobvt = VT.count() == 0 ? 'N' : 'A';
+    let info  = f._val(Layout::Col, jobu, jobvt, A._dims[0], A._dims[1], A._data, A._step[1], s._data, U._data, U._step[1], VT._data, VT._step[1], superb._data);
+    (void)info;
 }
 
 // A -> A'
-pub fn getri(mf64 A, vu32 vp) -> void {
-    static let f = get_fun<void(Layout layout, u32 n, f64* ma, u32 lda, u32* vp)>("cblas_dgetri");
+pub fn getri(mf32 A, vu32 vp) -> u32 {
+    if (!use_lapacke(A)) {
+        return native::getri(A, vp);
+    }
+
+    static let f = get_fun<i32(Layout layout, u32 n, f32* ma, u32 lda, u32* vp)>("LAPACKE_sgetri");
     if (f.is_none()) {
-        return;
+        return native::getri(A, vp);
     }
-    
-    f._val(Layout::Col, A._dims[0], A._data, A._step[1], vp._data);
+
+    shift_pivots(vp, A._dims[0], +1);
+    let info = f._val(Layout::Col, A._dims[0], A._data, A._step[1], vp._data);
+    shift_pivots(vp, A._dims[0], -1);
+    return info > 0 ? u32(info) : 0u;
 }
 
-// A*x = b
-pub fn getrs(mf32 A, vu32 vp, vf32 b) -> void {
-    static let f = get_fun<void(Layout layout, u32 n, f32* ma, u32 lda, u32* vp, f32* b, u32 ldb)>("cblas_sgetrs");
+// A -> A'
+pub fn getri(mf64 A, vu32 vp) -> u32 {
+    if (!use_lapacke(A)) {
+        return native::getri(A, vp);
+    }
+
+    static let f = get_fun<i32(Layout layout, u32 n, f64* ma, u32 lda, u32* vp)>("LAPACKE_dgetri");
     if (f.is_none()) {
-        return;
+        return native::getri(A, vp);
     }
-    
-    f._val(Layout::Col, A._dims[0], A._data, A._step[1], vp._data, b._data, b._step[1]);
+
+    shift_pivots(vp, A._dims[0], +1);
+    let info = f._val(Layout::Col, A._dims[0], A._data, A._step[1], vp._data);
+    shift_pivots(vp, A._dims[0], -1);
+    return info > 0 ? u32(info) : 0u;
 }
 
 // A*X = B
-pub fn getrs(mf64 A, vu32 vp, vf64 b) -> void {
-    static let f = get_fun<void(Layout layout, u32 n, f64* ma, u32 lda, u32* vp, f64* b, u32 ldb)>("cblas_sgetrs");
+pub fn getrs(mf32 A, vu32 vp, mf32 B) -> void {
+    if (!use_lapacke(A) || B._step[0] != 1) {
+        return native::getrs(A, vp, B);
+    }
+
+    static let f = get_fun<i32(Layout layout, char trans, u32 n, u32 nrhs, f32* ma, u32 lda, u32* vp, f32* b, u32 ldb)>("LAPACKE_sgetrs");
     if (f.is_none()) {
-        return;
+        return native::getrs(A, vp, B);
     }
-    
-    f._val(Layout::Col, A._dims[0], A._data, A._step[1], vp._data, b._data, b._step[1]);
-}
 
+    shift_pivots(vp, A._dims[0], +1);
+    f._val(Layout::Col, 'N', A._dims[0], B._dims[1], A._data, A._step[1], vp._data, B._data, B._step[1]);
+    shift_pivots(vp, A._dims[0], -1);
 }
 
-// fft
-inline namespace fft
-{
+// A*X = B
+pub fn getrs(mf64 A, vu32 vp, mf64 B) -> void {
+    if (!use_lapacke(A) || B._step[0] != 1) {
+        return native::getrs(A, vp, B);
+    }
 
-enum fft_t
-{};
+    static let f = get_fun<i32(Layout layout, char trans, u32 n, u32 nrhs, f64* ma, u32 lda, u32* vp, f64* b, u32 ldb)>("LAPACKE_dgetrs");
+    if (f.is_none()) {
+        return native::getrs(A, vp, B);
+    }
 
-class Contex
-{
+    shift_pivots(vp, A._dims[0], +1);
+    f._val(Layout::Col, 'N', A._dims[0], B._dims[1], A._data, A._step[1], vp._data, B._data, B._step[1]);
+    shift_pivots(vp, A._dims[0], -1);
+}
 
-};
+// A*x = b
+pub fn getrs(mf32 A, vu32 vp, vf32 b) -> void {
+    let n = b._dims[0];
+    getrs(A, vp, mf32(b._data, u32x2{ n, 1 }, i32x2{ b._step[0], i32(n) * b._step[0] }));
+}
+
+// A*x = b
+pub fn getrs(mf64 A, vu32 vp, vf64 b) -> void {
+    let n = b._dims[0];
+    getrs(A, vp, mf64(b._data, u32x2{ n, 1 }, i32x2{ b._step[0], i32(n) * b._step[0] }));
+}
 
 }
 
@@ -2,15 +2,23 @@
 
 #include "ustd/core.h"
 #include "ustd/math/ndslice.h"
+#include "ustd/math/native.h"
 
 namespace ustd::math
 {
 
-using vf32 = NDSlice<f32, 1>;
-using vf64 = NDSlice<f64, 1>;
-using mf32 = NDSlice<f32, 2>;
-using mf64 = NDSlice<f64, 2>;
-using vu32 = NDSlice<u32, 1>;
+// backend: where `blas` and `lapack` run
+enum class Backend
+{
+    Auto,       // MKL when `mkl_rt` loads, Native otherwise
+    Native,     // built-in kernels, see `math::native`
+    MKL,        // `mkl_rt`, Native for missing symbols
+};
+
+pub fn set_backend(Backend backend) noexcept -> void;
+
+// the backend in use, never `Auto`
+pub fn get_backend() noexcept -> Backend;
 
 inline namespace blas
 {
@@ -68,11 +76,11 @@ pub fn gemm(f64 alpha, mf64 A, mf64 B, f64 beta, mf64 C) -> void;
 inline namespace lapack
 {
 
-// A = P*L*U
-pub fn getrf(mf32 A, vu32 vp) -> void;
+// A = P*L*U, row i was swapped with row vp(i) (0-based); returns 0, or i+1 if U(i,i) == 0
+pub fn getrf(mf32 A, vu32 vp) -> u32;
 
 // A = P*L*U
-pub fn getrf(mf64 A, vu32 vp) -> void;
+pub fn getrf(mf64 A, vu32 vp) -> u32;
 
 // A = QR
 pub fn geqrf(mf32 A, vf32 tau) -> void;
@@ -80,24 +88,30 @@ pub fn geqrf(mf32 A, vf32 tau) -> void;
 // A = QR
 pub fn geqrf(mf64 A, vf64 tau) -> void;
 
-// A = SVD
+// A = SVD, MKL only
 pub fn gesvd(mf32 A, vf32 s, mf32 U, mf32 VT) -> void;
 
-// A -> A'
-pub fn getri(mf32 A, vu32 vp) -> void;
+// A = SVD, MKL only
+pub fn gesvd(mf64 A, vf64 s, mf64 U, mf64 VT) -> void;
+
+// A -> A', returns 0, or i+1 if U(i,i) == 0
+pub fn getri(mf32 A, vu32 vp) -> u32;
 
 // A -> A'
-pub fn getri(mf64 A, vu32 vp) -> void;
+pub fn getri(mf64 A, vu32 vp) -> u32;
 
 // A*x = b
 pub fn getrs(mf32 A, vu32 vp, vf32 b) -> void;
 
-// A*X = B
+// A*x = b
 pub fn getrs(mf64 A, vu32 vp, vf64 b) -> void;
 
-}
+// A*X = B
+pub fn getrs(mf32 A, vu32 vp, mf32 B) -> void;
 
-inline namespace fft
-{}
+// A*X = B
+pub fn getrs(mf64 A, vu32 vp, mf64 B) -> void;
+
+}
 
 }
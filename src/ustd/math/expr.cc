@@ -42,6 +42,32 @@ unittest(vsum)
     assert_eq(sum_a2(), 64.f);
 }
 
+unittest(packet)
+{
+    // odd length: packets + scalar tail
+    let cnt = 1000u + 3u;
+    mut x   = NDArray<f32>::with_dims({ cnt });
+    mut y   = NDArray<f32>::with_dims({ cnt });
+
+    x <<= vline(1.f);
+    y <<= 1.f;
+    y += 0.5f * x;
+    for (mut i = 0u; i < cnt; ++i) {
+        assert_eq(y(i), 1.f + 0.5f * f32(i));
+    }
+
+    // strided dim 0: scalar path
+    mut a = NDArray<f32, 2>::with_dims({ 8, 8 });
+    mut b = NDSlice<f32, 2>(a._data, u32x2{ 8u, 8u }, i32x2{ 8, 1 });
+    a <<= vline(1.f, 100.f);
+    b += 1.f;
+    for (mut i = 0u; i < 8u; ++i) {
+        for (mut j = 0u; j < 8u; ++j) {
+            assert_eq(a(i, j), f32(i) + 100.f * f32(j) + 1.f);
+        }
+    }
+}
+
 unittest(axpy)
 {
 
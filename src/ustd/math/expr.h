@@ -35,6 +35,19 @@ struct parallel_t<F, A>: ndvec_t<res_t<F, A>, A::$rank>
         let r = F()(a);
         return r;
     }
+
+    template<class V>
+    constexpr static let $packet = $packet_op<F> && $is_same<res_t<F, A>, V> && A::template $packet<V>;
+
+    fn is_packed() const noexcept -> bool {
+        return _a.is_packed();
+    }
+
+    template<class P, typename ...I>
+    fn load_packet(I ...idx) const noexcept -> P {
+        let a = _a.template load_packet<P>(idx...);
+        return F()(a);
+    }
 };
 
 /* parallel: f(a, b) */
@@ -61,6 +74,20 @@ struct parallel_t<F, A, B>: ndvec_t<res_t<F, A, B>, A::$rank|B::$rank >
         let r = F()(a, b);
         return r;
     }
+
+    template<class V>
+    constexpr static let $packet = $packet_op<F> && $is_same<res_t<F, A, B>, V> && A::template $packet<V> && B::template $packet<V>;
+
+    fn is_packed() const noexcept -> bool {
+        return _a.is_packed() && _b.is_packed();
+    }
+
+    template<class P, typename ...I>
+    fn load_packet(I ...idx) const noexcept -> P {
+        let a = _a.template load_packet<P>(idx...);
+        let b = _b.template load_packet<P>(idx...);
+        return F()(a, b);
+    }
 };
 
 template<typename F, typename ...T>
@@ -0,0 +1,815 @@
+#include "config.inl"
+#include "ustd/math/fft.h"
+
+namespace ustd::math::fft
+{
+
+// transforms with fewer points (length * lines) run on the calling thread
+static constexpr let $par_min     = 1u << 15;
+
+// split buffers of one group of lines, lines of a group share every stage pass
+static constexpr let $group_bytes = 256u << 10;
+
+// inner indices of one stage task
+static constexpr let $q_chunk     = 512u;
+
+static constexpr let $pi = 3.14159265358979323846;
+
+#pragma region kernel
+template<class T, class V>
+static fn _load(const T* p) noexcept -> V {
+    if constexpr ($is_same<T, V>) {
+        return *p;
+    }
+    else {
+        return V::load(p);
+    }
+}
+
+template<class T, class V>
+static fn _store(T* p, const V& v) noexcept -> void {
+    if constexpr ($is_same<T, V>) {
+        *p = v;
+    }
+    else {
+        v.store(p);
+    }
+}
+
+template<class T, class V>
+static fn _splat(T v) noexcept -> V {
+    if constexpr ($is_same<T, V>) {
+        return v;
+    }
+    else {
+        return V::splat(v);
+    }
+}
+
+// y[j] = sum(a[k] * exp(-2*pi*i*j*k/r)), in place, r in {2, 3, 4, 5}
+template<class T, class V>
+static fn _butterfly(u32 r, V* ar, V* ai) noexcept -> void {
+    switch (r) {
+    case 2: {
+        let tr = ar[0] - ar[1];
+        let ti = ai[0] - ai[1];
+        ar[0] += ar[1];
+        ai[0] += ai[1];
+        ar[1] = tr;
+        ai[1] = ti;
+        break;
+    }
+    case 3: {
+        let c  = _splat<T, V>(T(-0.5));
+        let s  = _splat<T, V>(T(0.86602540378443864676));
+        let br = ar[1] + ar[2];
+        let bi = ai[1] + ai[2];
+        let dr = (ar[1] - ar[2]) * s;
+        let di = (ai[1] - ai[2]) * s;
+        let tr = ar[0] + br * c;
+        let ti = ai[0] + bi * c;
+        ar[0] += br;
+        ai[0] += bi;
+        // t -/+ i*d
+        ar[1] = tr + di;
+        ai[1] = ti - dr;
+        ar[2] = tr - di;
+        ai[2] = ti + dr;
+        break;
+    }
+    case 4: {
+        let t0r = ar[0] + ar[2];
+        let t0i = ai[0] + ai[2];
+        let t1r = ar[0] - ar[2];
+        let t1i = ai[0] - ai[2];
+        let t2r = ar[1] + ar[3];
+        let t2i = ai[1] + ai[3];
+        // -i*(a1 - a3)
+        let t3r = ai[1] - ai[3];
+        let t3i = ar[3] - ar[1];
+        ar[0] = t0r + t2r;
+        ai[0] = t0i + t2i;
+        ar[2] = t0r - t2r;
+        ai[2] = t0i - t2i;
+        ar[1] = t1r + t3r;
+        ai[1] = t1i + t3i;
+        ar[3] = t1r - t3r;
+        ai[3] = t1i - t3i;
+        break;
+    }
+    case 5: {
+        let c1  = _splat<T, V>(T(0.30901699437494742410));
+        let c2  = _splat<T, V>(T(-0.80901699437494742410));
+        let s1  = _splat<T, V>(T(0.95105651629515357212));
+        let s2  = _splat<T, V>(T(0.58778525229247312917));
+        let b1r = ar[1] + ar[4];
+        let b1i = ai[1] + ai[4];
+        let b2r = ar[2] + ar[3];
+        let b2i = ai[2] + ai[3];
+        let d1r = ar[1] - ar[4];
+        let d1i = ai[1] - ai[4];
+        let d2r = ar[2] - ar[3];
+        let d2i = ai[2] - ai[3];
+        let t1r = ar[0] + b1r * c1 + b2r * c2;
+        let t1i = ai[0] + b1i * c1 + b2i * c2;
+        let t2r = ar[0] + b1r * c2 + b2r * c1;
+        let t2i = ai[0] + b1i * c2 + b2i * c1;
+        let u1r = d1r * s1 + d2r * s2;
+        let u1i = d1i * s1 + d2i * s2;
+        let u2r = d1r * s2 - d2r * s1;
+        let u2i = d1i * s2 - d2i * s1;
+        ar[0] += b1r + b2r;
+        ai[0] += b1i + b2i;
+        // t -/+ i*u
+        ar[1] = t1r + u1i;
+        ai[1] = t1i - u1r;
+        ar[4] = t1r - u1i;
+        ai[4] = t1i + u1r;
+        ar[2] = t2r + u2i;
+        ai[2] = t2i - u2r;
+        ar[3] = t2r - u2i;
+        ai[3] = t2i + u2r;
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+// one butterfly of a stage at (p, q), V lanes over q
+//  y[q + s*(r*p + j)] = w^(p*j) * sum(x[q + s*(p + k*m)] * exp(-2*pi*i*j*k/r))
+template<class T, class V>
+static fn _stage_at(u32 r, u32 m, u64 s, const T* tw, const T* xr, const T* xi, T* yr, T* yi, u32 p, u64 q) noexcept -> void {
+    V ar[5];
+    V ai[5];
+    for (mut k = 0u; k < r; ++k) {
+        let idx = q + s * (p + u64(k) * m);
+        ar[k] = _load<T, V>(xr + idx);
+        ai[k] = _load<T, V>(xi + idx);
+    }
+
+    _butterfly<T, V>(r, ar, ai);
+
+    let y0 = q + s * u64(r) * p;
+    _store<T, V>(yr + y0, ar[0]);
+    _store<T, V>(yi + y0, ai[0]);
+
+    let twp = tw + 2 * u64(p) * (r - 1);
+    for (mut j = 1u; j < r; ++j) {
+        let yj = y0 + s * j;
+        if (p == 0) {
+            _store<T, V>(yr + yj, ar[j]);
+            _store<T, V>(yi + yj, ai[j]);
+            continue;
+        }
+        let wr = _splat<T, V>(twp[2 * (j - 1) + 0]);
+        let wi = _splat<T, V>(twp[2 * (j - 1) + 1]);
+        _store<T, V>(yr + yj, ar[j] * wr - ai[j] * wi);
+        _store<T, V>(yi + yj, ar[j] * wi + ai[j] * wr);
+    }
+}
+
+// stage butterflies at p, q in [q0, q1)
+template<class T>
+static fn _stage(u32 r, u32 m, u64 s, const T* tw, const T* xr, const T* xi, T* yr, T* yi, u32 p, u64 q0, u64 q1) noexcept -> void {
+    using P = packet_t<T>;
+
+    mut q = q0;
+    for (; q + P::$size <= q1; q += P::$size) {
+        _stage_at<T, P>(r, m, s, tw, xr, xi, yr, yi, p, q);
+    }
+    for (; q < q1; ++q) {
+        _stage_at<T, T>(r, m, s, tw, xr, xi, yr, yi, p, q);
+    }
+}
+
+// radix stages over `cnt` split sequences of plan._size points, in place
+template<class T>
+static fn _stages(const FFTPlan<T>& plan, T* re, T* im, T* tr, T* ti, u32 cnt, bool par) noexcept -> void {
+    let total = u64(plan._size) * cnt;
+    par = par && total >= $par_min;
+
+    mut xr = re;
+    mut xi = im;
+    mut yr = tr;
+    mut yi = ti;
+    mut tw = plan._twiddle._data;
+    mut n  = plan._size;
+    mut s  = u64(cnt);
+
+    for (mut i = 0u; i < plan._radix._size; ++i) {
+        let r  = plan._radix[i];
+        let m  = n / r;
+        let qb = (s + $q_chunk - 1) / $q_chunk;
+
+        let task = [&](u64 w) {
+            let p  = u32(w / qb);
+            let q0 = (w % qb) * $q_chunk;
+            let q1 = ustd::min(q0 + $q_chunk, s);
+            _stage(r, m, s, tw, xr, xi, yr, yi, p, q0, q1);
+        };
+
+        let task_cnt = u64(m) * qb;
+        if (par && task_cnt > 1) {
+            let grain = ustd::max(u64(1), u64($par_min / 8) / (u64(r) * ustd::min(s, u64($q_chunk))));
+            thread::parallel_for(thread::Range{ 0, task_cnt }, grain, [&](thread::Range rng) {
+                for (mut w = rng._start; w < rng._end; ++w) {
+                    task(w);
+                }
+            });
+        }
+        else {
+            for (mut w = u64(0); w < task_cnt; ++w) {
+                task(w);
+            }
+        }
+
+        tw += 2 * u64(m) * (r - 1);
+        ustd::swap(xr, yr);
+        ustd::swap(xi, yi);
+        n  = m;
+        s *= r;
+    }
+
+    if (xr != re) {
+        ustd::mcpy(re, xr, total);
+        ustd::mcpy(im, xi, total);
+    }
+}
+
+template<class T>
+static fn _conj(T* im, u64 cnt) noexcept -> void {
+    for (mut i = u64(0); i < cnt; ++i) {
+        im[i] = -im[i];
+    }
+}
+#pragma endregion
+
+#pragma region plan
+static fn _is_smooth(u32 n) noexcept -> bool {
+    const u32 primes[] = { 2, 3, 5 };
+    for (let f : primes) {
+        while (n % f == 0) n /= f;
+    }
+    return n == 1;
+}
+
+// 4s first, then 2, 3, 5
+static fn _factor(u32 n, List<u32>& radix) noexcept -> void {
+    while (n % 4 == 0) { radix.push(4u); n /= 4; }
+    while (n % 2 == 0) { radix.push(2u); n /= 2; }
+    while (n % 3 == 0) { radix.push(3u); n /= 3; }
+    while (n % 5 == 0) { radix.push(5u); n /= 5; }
+}
+
+template<class T>
+static fn _make_plan(u32 len) noexcept -> FFTPlan<T> {
+    mut res = FFTPlan<T>{ len, len, List<u32>{}, List<T>{}, List<T>{}, List<T>{} };
+    if (len <= 1) {
+        return res;
+    }
+
+    if (!_is_smooth(len)) {
+        mut size = 2 * len - 1;
+        while (!_is_smooth(size)) ++size;
+        res._size = size;
+    }
+    _factor(res._size, res._radix);
+
+    // twiddles: exp(-2*pi*i*p*j/n) of each stage
+    res._twiddle = List<T>::with_capacity(2 * res._size);
+    mut n = res._size;
+    for (mut i = 0u; i < res._radix._size; ++i) {
+        let r = res._radix[i];
+        let m = n / r;
+        for (mut p = 0u; p < m; ++p) {
+            for (mut j = 1u; j < r; ++j) {
+                let a = -2.0 * $pi * f64(u64(p) * j) / f64(n);
+                res._twiddle.push(T(math::cos(a)));
+                res._twiddle.push(T(math::sin(a)));
+            }
+        }
+        n = m;
+    }
+
+    if (!res.is_bluestein()) {
+        return res;
+    }
+
+    // chirp: exp(-i*pi*k*k/len), k*k mod 2*len keeps the angle small
+    res._chirp = List<T>::with_capacity(2 * len);
+    for (mut k = 0u; k < len; ++k) {
+        let kk = (u64(k) * k) % (2 * u64(len));
+        let a  = -$pi * f64(kk) / f64(len);
+        res._chirp.push(T(math::cos(a)));
+        res._chirp.push(T(math::sin(a)));
+    }
+
+    // kernel: DFT of the conjugated chirp, wrapped around
+    let size = res._size;
+    res._kernel = List<T>::with_capacity(2 * size);
+    res._kernel.pushn(2 * size, T(0));
+    mut kr = res._kernel._data;
+    mut ki = res._kernel._data + size;
+    for (mut k = 0u; k < len; ++k) {
+        kr[k] =  res._chirp[2 * k + 0];
+        ki[k] = -res._chirp[2 * k + 1];
+        if (k != 0) {
+            kr[size - k] = kr[k];
+            ki[size - k] = ki[k];
+        }
+    }
+
+    mut tmp = mnew<T>(2 * size);
+    _stages(res, kr, ki, tmp, tmp + size, 1, true);
+    mdel(tmp);
+
+    let inv = T(1) / T(size);
+    for (mut k = 0u; k < 2 * size; ++k) {
+        res._kernel[k] *= inv;
+    }
+    return res;
+}
+
+template<class T>
+static fn _exec_split(const FFTPlan<T>& plan, T* re, T* im, u32 cnt, FFTDir dir, bool par) noexcept -> void {
+    let len = plan._len;
+    if (len <= 1 || cnt == 0) {
+        return;
+    }
+
+    // inverse: conj(DFT(conj(x)))
+    let points = u64(len) * cnt;
+    if (dir == FFTDir::Inverse) {
+        _conj(im, points);
+    }
+
+    if (!plan.is_bluestein()) {
+        mut tmp = mnew<T>(2 * points);
+        _stages(plan, re, im, tmp, tmp + points, cnt, par);
+        mdel(tmp);
+    }
+    else {
+        // X[k] = c[k] * IDFT(DFT(x*c) * DFT(conj(c)))[k], c = chirp
+        let size  = u64(plan._size) * cnt;
+        mut buf   = mnew<T>(4 * size);
+        mut ar    = buf;
+        mut ai    = buf + size;
+        let chirp = plan._chirp._data;
+        let kr    = plan._kernel._data;
+        let ki    = plan._kernel._data + plan._size;
+
+        for (mut k = 0u; k < len; ++k) {
+            let cr = chirp[2 * k + 0];
+            let ci = chirp[2 * k + 1];
+            for (mut b = 0u; b < cnt; ++b) {
+                let i  = u64(k) * cnt + b;
+                ar[i] = re[i] * cr - im[i] * ci;
+                ai[i] = re[i] * ci + im[i] * cr;
+            }
+        }
+        for (mut i = points; i < size; ++i) {
+            ar[i] = T(0);
+            ai[i] = T(0);
+        }
+
+        _stages(plan, ar, ai, buf + 2 * size, buf + 3 * size, cnt, par);
+
+        // conj(A*K), so the next forward pass is an inverse one
+        for (mut k = 0u; k < plan._size; ++k) {
+            for (mut b = 0u; b < cnt; ++b) {
+                let i  = u64(k) * cnt + b;
+                let xr = ar[i] * kr[k] - ai[i] * ki[k];
+                let xi = ar[i] * ki[k] + ai[i] * kr[k];
+                ar[i] =  xr;
+                ai[i] = -xi;
+            }
+        }
+
+        _stages(plan, ar, ai, buf + 2 * size, buf + 3 * size, cnt, par);
+
+        // c * conj(Z)
+        for (mut k = 0u; k < len; ++k) {
+            let cr = chirp[2 * k + 0];
+            let ci = chirp[2 * k + 1];
+            for (mut b = 0u; b < cnt; ++b) {
+                let i  = u64(k) * cnt + b;
+                let zr =  ar[i];
+                let zi = -ai[i];
+                re[i] = zr * cr - zi * ci;
+                im[i] = zr * ci + zi * cr;
+            }
+        }
+        mdel(buf);
+    }
+
+    if (dir == FFTDir::Inverse) {
+        _conj(im, points);
+    }
+}
+
+// lines per group: the split buffers of a group stay in $group_bytes, lanes filled when possible
+template<class T>
+static fn _group_size(u32 len, u32 cnt) noexcept -> u32 {
+    let lanes = packet_t<T>::$size;
+    mut res   = u32(ustd::max(u64(1), u64($group_bytes) / (4 * sizeof(T) * ustd::max(len, 1u))));
+    res = ustd::min(res, cnt);
+    if (res > lanes) {
+        res -= res % lanes;
+    }
+    return res;
+}
+
+// f(l0, l1, par) over groups of lines, groups across threads when there are many
+template<class T, class F>
+static fn _for_groups(u32 len, u32 cnt, F&& f) noexcept -> void {
+    let group     = _group_size<T>(len, cnt);
+    let group_cnt = (cnt + group - 1) / group;
+    let par       = group_cnt > 1 && u64(len) * cnt >= $par_min;
+
+    if (!par) {
+        for (mut g = 0u; g < group_cnt; ++g) {
+            f(g * group, ustd::min(cnt, (g + 1) * group), true);
+        }
+        return;
+    }
+
+    thread::parallel_for(thread::Range{ 0, group_cnt }, 1, [&](thread::Range rng) {
+        for (mut g = u32(rng._start); g < u32(rng._end); ++g) {
+            f(g * group, ustd::min(cnt, (g + 1) * group), false);
+        }
+    });
+}
+
+template<class T>
+static fn _re(const complex_t<T>* z) noexcept -> T { return reinterpret_cast<const T*>(z)[0]; }
+
+template<class T>
+static fn _im(const complex_t<T>* z) noexcept -> T { return reinterpret_cast<const T*>(z)[1]; }
+
+template<class T>
+static fn _set(complex_t<T>* z, T re, T im) noexcept -> void {
+    mut p = reinterpret_cast<T*>(z);
+    p[0] = re;
+    p[1] = im;
+}
+
+template<class T>
+static fn _exec_lines(const FFTPlan<T>& plan, const Lines<complex_t<T>>& x, FFTDir dir) noexcept -> void {
+    let len = plan._len;
+    if (x._len != len) {
+        log::error("ustd::math::fft::FFTPlan[len={}].exec(x.len={}) -> Error(`len not match`)", len, x._len);
+        return;
+    }
+    if (len <= 1 || x._cnt == 0) {
+        return;
+    }
+
+    _for_groups<T>(len, x._cnt, [&](u32 l0, u32 l1, bool par) {
+        let cnt = l1 - l0;
+        let points = u64(len) * cnt;
+        mut buf = mnew<T>(2 * points);
+        mut re  = buf;
+        mut im  = buf + points;
+
+        for (mut b = 0u; b < cnt; ++b) {
+            let line = x[l0 + b];
+            for (mut k = 0u; k < len; ++k) {
+                let z = line + k * x._step;
+                re[u64(k) * cnt + b] = _re<T>(z);
+                im[u64(k) * cnt + b] = _im<T>(z);
+            }
+        }
+
+        _exec_split(plan, re, im, cnt, dir, par);
+
+        for (mut b = 0u; b < cnt; ++b) {
+            mut line = x[l0 + b];
+            for (mut k = 0u; k < len; ++k) {
+                _set<T>(line + k * x._step, re[u64(k) * cnt + b], im[u64(k) * cnt + b]);
+            }
+        }
+        mdel(buf);
+    });
+}
+
+template<class T>
+static fn _make_rplan(u32 len) noexcept -> RFFTPlan<T> {
+    let half = len % 2 == 0 ? len / 2 : len;
+    mut res  = RFFTPlan<T>{ len, FFTPlan<T>::with_len(half), List<T>::with_capacity(len + 2) };
+    for (mut k = 0u; k <= len / 2; ++k) {
+        let a = -2.0 * $pi * f64(k) / f64(len);
+        res._twiddle.push(T(math::cos(a)));
+        res._twiddle.push(T(math::sin(a)));
+    }
+    return res;
+}
+
+template<class T>
+static fn _exec_r2c(const RFFTPlan<T>& plan, const Lines<T>& x, const Lines<complex_t<T>>& X) noexcept -> void {
+    let len = plan._len;
+    if (x._len != len || X._len != len / 2 + 1 || x._cnt != X._cnt) {
+        log::error("ustd::math::fft::RFFTPlan[len={}].exec_r2c(x.len={}, X.len={}) -> Error(`len not match`)", len, x._len, X._len);
+        return;
+    }
+    if (len == 0 || x._cnt == 0) {
+        return;
+    }
+
+    let even = len % 2 == 0;
+    let n    = plan._plan._len;
+    _for_groups<T>(n, x._cnt, [&](u32 l0, u32 l1, bool par) {
+        let cnt    = l1 - l0;
+        let points = u64(n) * cnt;
+        mut buf    = mnew<T>(2 * points);
+        mut re     = buf;
+        mut im     = buf + points;
+
+        // even: z[j] = x[2j] + i*x[2j+1]
+        for (mut b = 0u; b < cnt; ++b) {
+            let line = x[l0 + b];
+            for (mut j = 0u; j < n; ++j) {
+                let i = u64(j) * cnt + b;
+                re[i] = even ? line[(2 * j + 0) * x._step] : line[j * x._step];
+                im[i] = even ? line[(2 * j + 1) * x._step] : T(0);
+            }
+        }
+
+        _exec_split(plan._plan, re, im, cnt, FFTDir::Forward, par);
+
+        let tw = plan._twiddle._data;
+        for (mut b = 0u; b < cnt; ++b) {
+            mut line = X[l0 + b];
+            if (!even) {
+                for (mut k = 0u; k <= len / 2; ++k) {
+                    let i = u64(k) * cnt + b;
+                    _set<T>(line + k * X._step, re[i], im[i]);
+                }
+                continue;
+            }
+
+            // X[k] = E[k] + w^k*O[k], E = (Z[k] + conj(Z[n-k]))/2, O = (Z[k] - conj(Z[n-k]))/2i
+            for (mut k = 0u; k <= n; ++k) {
+                let i  = u64(k % n) * cnt + b;
+                let c  = u64((n - k) % n) * cnt + b;
+                let er = T(0.5) * (re[i] + re[c]);
+                let ei = T(0.5) * (im[i] - im[c]);
+                let dr = T(0.5) * (im[i] + im[c]);
+                let di = T(0.5) * (re[c] - re[i]);
+                let wr = tw[2 * k + 0];
+                let wi = tw[2 * k + 1];
+                _set<T>(line + k * X._step, er + wr * dr - wi * di, ei + wr * di + wi * dr);
+            }
+        }
+        mdel(buf);
+    });
+}
+
+template<class T>
+static fn _exec_c2r(const RFFTPlan<T>& plan, const Lines<complex_t<T>>& X, const Lines<T>& x) noexcept -> void {
+    let len = plan._len;
+    if (x._len != len || X._len != len / 2 + 1 || x._cnt != X._cnt) {
+        log::error("ustd::math::fft::RFFTPlan[len={}].exec_c2r(X.len={}, x.len={}) -> Error(`len not match`)", len, X._len, x._len);
+        return;
+    }
+    if (len == 0 || X._cnt == 0) {
+        return;
+    }
+
+    let even = len % 2 == 0;
+    let n    = plan._plan._len;
+    _for_groups<T>(n, X._cnt, [&](u32 l0, u32 l1, bool par) {
+        let cnt    = l1 - l0;
+        let points = u64(n) * cnt;
+        mut buf    = mnew<T>(2 * points);
+        mut re     = buf;
+        mut im     = buf + points;
+
+        let tw = plan._twiddle._data;
+        for (mut b = 0u; b < cnt; ++b) {
+            let line = X[l0 + b];
+            if (!even) {
+                // the full Hermitian spectrum
+                for (mut k = 0u; k <= len / 2; ++k) {
+                    let z = line + k * X._step;
+                    re[u64(k) * cnt + b] = _re<T>(z);
+                    im[u64(k) * cnt + b] = k == 0 ? T(0) : _im<T>(z);
+                    if (k != 0) {
+                        re[u64(len - k) * cnt + b] =  _re<T>(z);
+                        im[u64(len - k) * cnt + b] = -_im<T>(z);
+                    }
+                }
+                continue;
+            }
+
+            // Z[k] = (X[k] + conj(X[n-k])) + i*(X[k] - conj(X[n-k]))*conj(w^k)
+            for (mut k = 0u; k < n; ++k) {
+                let a  = line + k * X._step;
+                let c  = line + (n - k) * X._step;
+                let sr = _re<T>(a) + _re<T>(c);
+                let si = _im<T>(a) - _im<T>(c);
+                let dr = _re<T>(a) - _re<T>(c);
+                let di = _im<T>(a) + _im<T>(c);
+                let wr = tw[2 * k + 0];
+                let wi = -tw[2 * k + 1];
+                let tr = dr * wr - di * wi;
+                let ti = dr * wi + di * wr;
+                re[u64(k) * cnt + b] = sr - ti;
+                im[u64(k) * cnt + b] = si + tr;
+            }
+        }
+
+        _exec_split(plan._plan, re, im, cnt, FFTDir::Inverse, par);
+
+        for (mut b = 0u; b < cnt; ++b) {
+            mut line = x[l0 + b];
+            for (mut j = 0u; j < n; ++j) {
+                let i = u64(j) * cnt + b;
+                if (even) {
+                    line[(2 * j + 0) * x._step] = re[i];
+                    line[(2 * j + 1) * x._step] = im[i];
+                }
+                else {
+                    line[j * x._step] = re[i];
+                }
+            }
+        }
+        mdel(buf);
+    });
+}
+#pragma endregion
+
+#pragma region export
+template<class T>
+pub fn FFTPlan<T>::with_len(u32 len) noexcept -> FFTPlan {
+    return _make_plan<T>(len);
+}
+
+template<class T>
+pub fn FFTPlan<T>::exec_lines(const Lines<C>& x, FFTDir dir) const noexcept -> void {
+    _exec_lines(*this, x, dir);
+}
+
+template<class T>
+pub fn FFTPlan<T>::exec_split(T* re, T* im, u32 cnt, FFTDir dir, bool par) const noexcept -> void {
+    _exec_split(*this, re, im, cnt, dir, par);
+}
+
+template<class T>
+pub fn RFFTPlan<T>::with_len(u32 len) noexcept -> RFFTPlan {
+    return _make_rplan<T>(len);
+}
+
+template<class T>
+pub fn RFFTPlan<T>::exec_r2c_lines(const Lines<T>& x, const Lines<C>& X) const noexcept -> void {
+    _exec_r2c(*this, x, X);
+}
+
+template<class T>
+pub fn RFFTPlan<T>::exec_c2r_lines(const Lines<C>& X, const Lines<T>& x) const noexcept -> void {
+    _exec_c2r(*this, X, x);
+}
+
+template class FFTPlan<f32>;
+template class FFTPlan<f64>;
+template class RFFTPlan<f32>;
+template class RFFTPlan<f64>;
+#pragma endregion
+
+// X[k] = sum(x[j] * exp(-2*pi*i*j*k/n))
+static fn _dft_ref(const f64* xr, const f64* xi, u32 n, f64* yr, f64* yi) -> void {
+    for (mut k = 0u; k < n; ++k) {
+        mut sr = 0.0;
+        mut si = 0.0;
+        for (mut j = 0u; j < n; ++j) {
+            let a = -2.0 * $pi * f64((u64(j) * k) % n) / f64(n);
+            sr += xr[j] * math::cos(a) - xi[j] * math::sin(a);
+            si += xr[j] * math::sin(a) + xi[j] * math::cos(a);
+        }
+        yr[k] = sr;
+        yi[k] = si;
+    }
+}
+
+static fn _test_fft(u32 n) -> void {
+    mut x  = NDArray<cf64>::with_dims({ n });
+    mut xr = NDArray<f64>::with_dims({ n });
+    mut xi = NDArray<f64>::with_dims({ n });
+    mut yr = NDArray<f64>::with_dims({ n });
+    mut yi = NDArray<f64>::with_dims({ n });
+    for (mut j = 0u; j < n; ++j) {
+        xr(j) = math::sin(0.37 * j) + 0.1 * j;
+        xi(j) = math::cos(1.3 * j);
+        _set<f64>(&x(j), xr(j), xi(j));
+    }
+    _dft_ref(xr._data, xi._data, n, yr._data, yi._data);
+
+    let plan = FFTPlan<f64>::with_len(n);
+    plan.exec(x);
+    for (mut k = 0u; k < n; ++k) {
+        let s = ustd::max(ustd::abs(yr(k)) + ustd::abs(yi(k)), 1.0);
+        assert_eq(ustd::abs(_re<f64>(&x(k)) - yr(k)) <= 1e-9 * s * n, true);
+        assert_eq(ustd::abs(_im<f64>(&x(k)) - yi(k)) <= 1e-9 * s * n, true);
+    }
+
+    // inverse is not normalized
+    plan.exec(x, 0, FFTDir::Inverse);
+    for (mut j = 0u; j < n; ++j) {
+        assert_eq(ustd::abs(_re<f64>(&x(j)) / n - xr(j)) <= 1e-9 * n, true);
+        assert_eq(ustd::abs(_im<f64>(&x(j)) / n - xi(j)) <= 1e-9 * n, true);
+    }
+}
+
+unittest(fft)
+{
+    const u32 lens[] = { 1, 2, 3, 4, 5, 6, 7, 8, 11, 12, 15, 16, 60, 97, 128, 243, 625, 1000, 1013 };
+    for (let n : lens) {
+        _test_fft(n);
+    }
+}
+
+unittest(fft_batch)
+{
+    // 37 lines of 48 points along dim 1, so points are strided and lines are contiguous
+    let n   = 48u;
+    let cnt = 37u;
+    mut x   = NDArray<cf32, 2>::with_dims({ cnt, n });
+    for (mut i = 0u; i < cnt; ++i) {
+        for (mut j = 0u; j < n; ++j) {
+            _set<f32>(&x(i, j), f32(i + 1), f32(j % 3));
+        }
+    }
+
+    let plan = FFTPlan<f32>::with_len(n);
+    plan.exec(x, 1);
+    for (mut i = 0u; i < cnt; ++i) {
+        assert_eq(_re<f32>(&x(i, 0u)), f32((i + 1) * n));
+        assert_eq(_im<f32>(&x(i, 0u)), f32(n));
+        assert_eq(ustd::abs(_re<f32>(&x(i, 5u))) < 1e-3f, true);
+    }
+
+    // 2-D round trip
+    mut y = NDArray<cf64, 2>::with_dims({ 30, 14 });
+    for (mut i = 0u; i < 30u; ++i) {
+        for (mut j = 0u; j < 14u; ++j) {
+            _set<f64>(&y(i, j), f64(i * j), f64(i) - f64(j));
+        }
+    }
+    let plan2 = FFTPlanND<f64, 2>::with_dims({ 30, 14 });
+    plan2.exec(y);
+    plan2.exec(y, FFTDir::Inverse);
+    for (mut i = 0u; i < 30u; ++i) {
+        for (mut j = 0u; j < 14u; ++j) {
+            assert_eq(ustd::abs(_re<f64>(&y(i, j)) / 420 - f64(i * j)) < 1e-9, true);
+            assert_eq(ustd::abs(_im<f64>(&y(i, j)) / 420 - (f64(i) - f64(j))) < 1e-9, true);
+        }
+    }
+}
+
+unittest(fft_real)
+{
+    const u32 lens[] = { 1, 2, 8, 9, 14, 30, 97 };
+    for (let n : lens) {
+        mut x  = NDArray<f64>::with_dims({ n });
+        mut X  = NDArray<cf64>::with_dims({ n / 2 + 1 });
+        mut xr = NDArray<f64>::with_dims({ n });
+        mut xi = NDArray<f64>::with_dims({ n });
+        mut yr = NDArray<f64>::with_dims({ n });
+        mut yi = NDArray<f64>::with_dims({ n });
+        for (mut j = 0u; j < n; ++j) {
+            x(j)  = math::sin(0.7 * j) + 0.25 * j;
+            xr(j) = x(j);
+            xi(j) = 0.0;
+        }
+        _dft_ref(xr._data, xi._data, n, yr._data, yi._data);
+
+        let plan = RFFTPlan<f64>::with_len(n);
+        plan.exec_r2c(x, X);
+        for (mut k = 0u; k <= n / 2; ++k) {
+            assert_eq(ustd::abs(_re<f64>(&X(k)) - yr(k)) < 1e-9 * n, true);
+            assert_eq(ustd::abs(_im<f64>(&X(k)) - yi(k)) < 1e-9 * n, true);
+        }
+
+        plan.exec_c2r(X, x);
+        for (mut j = 0u; j < n; ++j) {
+            assert_eq(ustd::abs(x(j) / n - xr(j)) < 1e-9 * n, true);
+        }
+    }
+}
+
+unittest(fft_perf)
+{
+    let n = 1u << 20;
+    mut x = NDArray<cf32>::with_dims({ n });
+    for (mut j = 0u; j < n; ++j) {
+        _set<f32>(&x(j), f32(j % 7), 0.f);
+    }
+
+    let plan = FFTPlan<f32>::with_len(n);
+    let t0 = time::Instant::now();
+    plan.exec(x);
+    let t1 = time::Instant::now();
+    log::info("ustd::math::fft::FFTPlan[len={}]: {}", n, t1 - t0);
+}
+
+}
@@ -0,0 +1,199 @@
+#pragma once
+
+#include "ustd/core.h"
+#include "ustd/math/complex.h"
+#include "ustd/math/ndslice.h"
+
+namespace ustd::math
+{
+
+inline namespace fft
+{
+
+template<class T> struct _complex;
+template<>        struct _complex<f32> { using type = cf32; };
+template<>        struct _complex<f64> { using type = cf64; };
+
+template<class T>
+using complex_t = typename _complex<T>::type;
+
+enum class FFTDir
+{
+    Forward,    // X[k] = sum(x[j] * exp(-2*pi*i*j*k/n))
+    Inverse,    // x[j] = sum(X[k] * exp(+2*pi*i*j*k/n)), not divided by n
+};
+
+// lines: `_cnt` 1-D lines of `_len` points along one dim of an NDSlice, the other dims enumerate them
+template<class E>
+struct Lines
+{
+    constexpr static let $max_rank = 3u;
+
+    E*      _data;
+    u32     _len;
+    i64     _step;
+    u32     _cnt;
+    u32     _rank;
+    u32     _dims[$max_rank];
+    i64     _steps[$max_rank];
+
+    template<u32 N>
+    static fn from_ndslice(const NDSlice<E, N>& x, u32 dim) noexcept -> Lines {
+        static_assert(N <= $max_rank + 1, "ustd::math::fft::Lines: rank > 4");
+
+        mut res = Lines{ x._data, x._dims[dim], x._step[dim], 1u, 0u, {}, {} };
+        for (mut i = 0u; i < N; ++i) {
+            if (i == dim) continue;
+            res._dims[res._rank]  = x._dims[i];
+            res._steps[res._rank] = x._step[i];
+            res._cnt *= x._dims[i];
+            res._rank += 1;
+        }
+        return res;
+    }
+
+    // first point of line `idx`
+    fn operator[](u32 idx) const noexcept -> E* {
+        mut off = i64(0);
+        for (mut i = 0u; i < _rank; ++i) {
+            off += i64(idx % _dims[i]) * _steps[i];
+            idx /= _dims[i];
+        }
+        return _data + off;
+    }
+};
+
+// complex FFT of one length, any length:
+//  - 2, 3, 4, 5 mixed radix, self sorting
+//  - Bluestein on a 2^a*3^b*5^c length when `len` has a larger prime factor
+// the plan is read only after `with_len`, one plan can run on many threads
+template<class T>
+class FFTPlan
+{
+public:
+    using C = complex_t<T>;
+
+    u32         _len;
+    u32         _size;      // length of the radix stages: `_len`, or the Bluestein length
+    List<u32>   _radix;     // radix of each stage
+    List<T>     _twiddle;   // each stage: (r-1) complex twiddles per butterfly, re/im interleaved
+    List<T>     _chirp;     // Bluestein: exp(-i*pi*k*k/len), re/im interleaved
+    List<T>     _kernel;    // Bluestein: DFT of the conjugated chirp over `_size`, divided by `_size`, split re|im
+
+    pub static fn with_len(u32 len) noexcept -> FFTPlan;
+
+    fn len() const noexcept -> u32 {
+        return _len;
+    }
+
+    fn is_bluestein() const noexcept -> bool {
+        return _size != _len;
+    }
+
+    // x := DFT(x) along `dim`, lines of other dims are batched
+    template<u32 N>
+    fn exec(NDSlice<C, N> x, u32 dim = 0, FFTDir dir = FFTDir::Forward) const noexcept -> void {
+        exec_lines(Lines<C>::from_ndslice(x, dim), dir);
+    }
+
+    pub fn exec_lines(const Lines<C>& x, FFTDir dir) const noexcept -> void;
+
+    // `cnt` sequences in split format, point k of sequence b at [b + cnt*k]
+    pub fn exec_split(T* re, T* im, u32 cnt, FFTDir dir, bool par) const noexcept -> void;
+};
+
+// real FFT: n reals <-> n/2+1 complex, an n/2 complex FFT when n is even
+template<class T>
+class RFFTPlan
+{
+public:
+    using C = complex_t<T>;
+
+    u32         _len;
+    FFTPlan<T>  _plan;      // n/2 when even, n otherwise
+    List<T>     _twiddle;   // exp(-2*pi*i*k/n), k <= n/2, re/im interleaved
+
+    pub static fn with_len(u32 len) noexcept -> RFFTPlan;
+
+    fn len() const noexcept -> u32 {
+        return _len;
+    }
+
+    // X := DFT(x) along `dim`, X._dims[dim] == len/2 + 1
+    template<u32 N>
+    fn exec_r2c(NDSlice<T, N> x, NDSlice<C, N> X, u32 dim = 0) const noexcept -> void {
+        exec_r2c_lines(Lines<T>::from_ndslice(x, dim), Lines<C>::from_ndslice(X, dim));
+    }
+
+    // x := IDFT(X) along `dim`, not divided by n, imaginary parts of X[0] and X[n/2] are ignored
+    template<u32 N>
+    fn exec_c2r(NDSlice<C, N> X, NDSlice<T, N> x, u32 dim = 0) const noexcept -> void {
+        exec_c2r_lines(Lines<C>::from_ndslice(X, dim), Lines<T>::from_ndslice(x, dim));
+    }
+
+    pub fn exec_r2c_lines(const Lines<T>& x, const Lines<C>& X) const noexcept -> void;
+    pub fn exec_c2r_lines(const Lines<C>& X, const Lines<T>& x) const noexcept -> void;
+};
+
+// N-D complex FFT: one plan per dim, applied dim by dim
+template<class T, u32 N>
+class FFTPlanND
+{
+public:
+    using C = complex_t<T>;
+
+    List<FFTPlan<T>> _plans;
+
+    static fn with_dims(const vec<u32, N>& dims) noexcept -> FFTPlanND {
+        mut res = FFTPlanND{ List<FFTPlan<T>>::with_capacity(N) };
+        for (mut i = 0u; i < N; ++i) {
+            res._plans.push(FFTPlan<T>::with_len(dims[i]));
+        }
+        return res;
+    }
+
+    fn exec(NDSlice<C, N> x, FFTDir dir = FFTDir::Forward) const noexcept -> void {
+        for (mut i = 0u; i < N; ++i) {
+            _plans[i].exec(x, i, dir);
+        }
+    }
+};
+
+// N-D real FFT: real <-> half complex along dim 0, complex along the others
+template<class T, u32 N>
+class RFFTPlanND
+{
+public:
+    using C = complex_t<T>;
+
+    RFFTPlan<T>         _real;
+    List<FFTPlan<T>>    _plans;     // dims 1..N-1
+
+    static fn with_dims(const vec<u32, N>& dims) noexcept -> RFFTPlanND {
+        mut res = RFFTPlanND{ RFFTPlan<T>::with_len(dims[0]), List<FFTPlan<T>>::with_capacity(N) };
+        for (mut i = 1u; i < N; ++i) {
+            res._plans.push(FFTPlan<T>::with_len(dims[i]));
+        }
+        return res;
+    }
+
+    // X._dims[0] == x._dims[0]/2 + 1
+    fn exec_r2c(NDSlice<T, N> x, NDSlice<C, N> X) const noexcept -> void {
+        _real.exec_r2c(x, X, 0);
+        for (mut i = 1u; i < N; ++i) {
+            _plans[i - 1].exec(X, i, FFTDir::Forward);
+        }
+    }
+
+    // not divided by the point count, X is overwritten
+    fn exec_c2r(NDSlice<C, N> X, NDSlice<T, N> x) const noexcept -> void {
+        for (mut i = N - 1; i > 0; --i) {
+            _plans[i - 1].exec(X, i, FFTDir::Inverse);
+        }
+        _real.exec_c2r(X, x, 0);
+    }
+};
+
+}
+
+}
@@ -0,0 +1,1036 @@
+#include "config.inl"
+#include "ustd/math/native.h"
+
+namespace ustd::math::native
+{
+
+// vectors shorter than this run on the calling thread
+static constexpr let $par_min   = 1u << 16;
+
+// gemm with fewer multiply-adds runs on the calling thread
+static constexpr let $gemm_par_min = u64(1) << 18;
+
+#pragma region level1
+// y[i*dy] += a * x[i*dx], i in [0, n)
+template<class T>
+static fn _axpy_raw(u32 n, T a, const T* x, i32 dx, T* y, i32 dy) noexcept -> void {
+    using P = packet_t<T>;
+
+    mut i = 0u;
+    if (dx == 1 && dy == 1) {
+        let pa = P::splat(a);
+        for (; i + P::$size <= n; i += P::$size) {
+            mut py = P::load(y + i);
+            py.mul_add(pa, P::load(x + i));
+            py.store(y + i);
+        }
+    }
+    for (; i < n; ++i) {
+        y[i64(i) * dy] += a * x[i64(i) * dx];
+    }
+}
+
+// sum(x[i*dx] * y[i*dy]), i in [0, n)
+template<class T>
+static fn _dot_raw(u32 n, const T* x, i32 dx, const T* y, i32 dy) noexcept -> T {
+    using P = packet_t<T>;
+
+    mut i   = 0u;
+    mut res = T(0);
+    if (dx == 1 && dy == 1) {
+        mut acc0 = P::splat(T(0));
+        mut acc1 = P::splat(T(0));
+        for (; i + 2 * P::$size <= n; i += 2 * P::$size) {
+            acc0.mul_add(P::load(x + i),            P::load(y + i));
+            acc1.mul_add(P::load(x + i + P::$size), P::load(y + i + P::$size));
+        }
+        acc0 += acc1;
+        res = acc0.hsum();
+    }
+    for (; i < n; ++i) {
+        res += x[i64(i) * dx] * y[i64(i) * dy];
+    }
+    return res;
+}
+
+// run f(i0, i1) over [0, n), split across the pool when n is large
+template<class F>
+static fn _for_range(u32 n, u32 par_min, F&& f) noexcept -> void {
+    if (n < par_min) {
+        f(0u, n);
+        return;
+    }
+    thread::parallel_for(thread::Range{ 0, n }, par_min / 4, [&](thread::Range r) {
+        f(u32(r._start), u32(r._end));
+    });
+}
+
+// sum of f(i0, i1) over [0, n)
+template<class T, class F>
+static fn _sum_range(u32 n, u32 par_min, F&& f) noexcept -> T {
+    if (n < par_min) {
+        return f(0u, n);
+    }
+    return thread::parallel_reduce(thread::Range{ 0, n }, par_min / 4, T(0),
+        [&](thread::Range r, T acc) { return acc + f(u32(r._start), u32(r._end)); },
+        [](T a, T b) { return a + b; });
+}
+
+template<class T>
+static fn _iabs(const NDSlice<T, 1>& x, bool is_max) noexcept -> u32 {
+    let n = x._dims[0];
+    if (n == 0) {
+        return 0;
+    }
+
+    mut res = 0u;
+    mut val = ustd::abs(x(0u));
+    for (mut i = 1u; i < n; ++i) {
+        let v = ustd::abs(x(i));
+        if (is_max ? v > val : v < val) {
+            res = i;
+            val = v;
+        }
+    }
+    return res;
+}
+
+template<class T>
+static fn _asum(const NDSlice<T, 1>& x) noexcept -> T {
+    return _sum_range<T>(x._dims[0], $par_min, [&](u32 i0, u32 i1) {
+        T acc[4] = {};
+        mut i = i0;
+        for (; i + 4 <= i1; i += 4) {
+            acc[0] += ustd::abs(x(i + 0));
+            acc[1] += ustd::abs(x(i + 1));
+            acc[2] += ustd::abs(x(i + 2));
+            acc[3] += ustd::abs(x(i + 3));
+        }
+        for (; i < i1; ++i) {
+            acc[0] += ustd::abs(x(i));
+        }
+        return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+    });
+}
+
+template<class T>
+static fn _axpy(T alpha, const NDSlice<T, 1>& x, NDSlice<T, 1>& y) noexcept -> void {
+    let n = ustd::min(x._dims[0], y._dims[0]);
+    _for_range(n, $par_min, [&](u32 i0, u32 i1) {
+        _axpy_raw(i1 - i0, alpha, &x(i0), x._step[0], &y(i0), y._step[0]);
+    });
+}
+
+template<class T>
+static fn _dot(const NDSlice<T, 1>& x, const NDSlice<T, 1>& y) noexcept -> T {
+    let n = ustd::min(x._dims[0], y._dims[0]);
+    return _sum_range<T>(n, $par_min, [&](u32 i0, u32 i1) {
+        return _dot_raw(i1 - i0, &x(i0), x._step[0], &y(i0), y._step[0]);
+    });
+}
+
+// scaled by max|x|, so squares neither overflow nor underflow
+template<class T>
+static fn _nrm2(const NDSlice<T, 1>& x) noexcept -> T {
+    let n = x._dims[0];
+    if (n == 0) {
+        return T(0);
+    }
+
+    let scale = ustd::abs(x(_iabs(x, true)));
+    if (scale == T(0)) {
+        return T(0);
+    }
+
+    let inv = T(1) / scale;
+    let ssq = _sum_range<T>(n, $par_min, [&](u32 i0, u32 i1) {
+        mut acc = T(0);
+        for (mut i = i0; i < i1; ++i) {
+            let v = x(i) * inv;
+            acc += v * v;
+        }
+        return acc;
+    });
+    return scale * math::sqrt(ssq);
+}
+
+// x' = h0*x + h2*y, y' = h1*x + h3*y
+template<class T>
+static fn _rot(NDSlice<T, 1>& x, NDSlice<T, 1>& y, const vec<T, 4>& h) noexcept -> void {
+    let n = ustd::min(x._dims[0], y._dims[0]);
+    _for_range(n, $par_min, [&](u32 i0, u32 i1) {
+        for (mut i = i0; i < i1; ++i) {
+            let a = x(i);
+            let b = y(i);
+            x(i) = h[0] * a + h[2] * b;
+            y(i) = h[1] * a + h[3] * b;
+        }
+    });
+}
+
+template<class T>
+static fn _swap(NDSlice<T, 1>& x, NDSlice<T, 1>& y) noexcept -> void {
+    let n = ustd::min(x._dims[0], y._dims[0]);
+    for (mut i = 0u; i < n; ++i) {
+        ustd::swap(x(i), y(i));
+    }
+}
+#pragma endregion
+
+#pragma region level2
+template<class T>
+static fn _gemv(T alpha, const NDSlice<T, 2>& A, const NDSlice<T, 1>& x, T beta, NDSlice<T, 1>& y) noexcept -> void {
+    let m = A._dims[0];
+    let n = A._dims[1];
+    if (x._dims[0] != n || y._dims[0] != m) {
+        log::error("ustd::math::native::gemv(A={}x{}, x={}, y={}) -> Error(`dims not match`)", m, n, x._dims[0], y._dims[0]);
+        return;
+    }
+
+    let par_min = ustd::max($par_min / ustd::max(n, 1u), 64u);
+
+    _for_range(m, par_min, [&](u32 i0, u32 i1) {
+        mut yi = NDSlice<T, 1>(&y(i0), u32x1{ i1 - i0 }, i32x1{ y._step[0] });
+        if (beta == T(0)) {
+            yi <<= T(0);
+        }
+        else if (beta != T(1)) {
+            yi *= beta;
+        }
+
+        if (A._step[0] == 1) {
+            // column major: y[i0:i1] += (alpha*x[j]) * A[i0:i1, j]
+            for (mut j = 0u; j < n; ++j) {
+                _axpy_raw(i1 - i0, alpha * x(j), &A(i0, j), 1, &y(i0), y._step[0]);
+            }
+        }
+        else {
+            // row major: y[i] += alpha * dot(A[i, :], x)
+            for (mut i = i0; i < i1; ++i) {
+                y(i) += alpha * _dot_raw(n, &A(i, 0u), A._step[1], x._data, x._step[0]);
+            }
+        }
+    });
+}
+
+template<class T>
+static fn _ger(T alpha, const NDSlice<T, 1>& x, const NDSlice<T, 1>& y, NDSlice<T, 2>& A) noexcept -> void {
+    let m = A._dims[0];
+    let n = A._dims[1];
+    if (x._dims[0] != m || y._dims[0] != n) {
+        log::error("ustd::math::native::ger(x={}, y={}, A={}x{}) -> Error(`dims not match`)", x._dims[0], y._dims[0], m, n);
+        return;
+    }
+
+    let par_min = ustd::max($par_min / ustd::max(m, 1u), 16u);
+
+    _for_range(n, par_min, [&](u32 j0, u32 j1) {
+        for (mut j = j0; j < j1; ++j) {
+            _axpy_raw(m, alpha * y(j), x._data, x._step[0], &A(0u, j), A._step[0]);
+        }
+    });
+}
+#pragma endregion
+
+#pragma region level3
+// gemm blocking, after Goto & van de Geijn, "Anatomy of High-Performance Matrix Multiplication"
+//  - micro tile: $mr x $nr of C in registers, $mr = 2 packets
+//  - A is packed into $mc x $kc blocks (L2), B into $kc x $nc panels (L3)
+template<class T>
+struct GemmShape
+{
+    using P = packet_t<T>;
+
+    constexpr static let $pa = 2u;                  // packets per micro column
+    constexpr static let $mr = $pa * P::$size;
+    constexpr static let $nr = USTD_SIMD_BYTES >= 64 ? 8u : USTD_SIMD_BYTES >= 32 ? 6u : 4u;
+    constexpr static let $kc = 256u;
+    constexpr static let $mc = ustd::max(u32(512 / sizeof(T)) / $mr, 1u) * $mr;
+    constexpr static let $nc = $nr * 512u;
+    constexpr static let $ng = $nr * 16u;           // columns per task inside a panel
+};
+
+// per thread buffer for packed A blocks; jobs never nest, so one is enough
+template<class T>
+static fn _gemm_buf(u32 cnt) noexcept -> T* {
+    static thread_local mut buf = List<T>();
+    if (buf._capacity < cnt) {
+        let heap = Arena::Scope(nullptr);   // the buffer outlives the caller's arena
+        buf.reserve(cnt);
+    }
+    return buf._data;
+}
+
+// A[i0:i0+mc, p0:p0+kc] -> $mr row slivers, zero padded
+template<class T>
+static fn _pack_a(const NDSlice<T, 2>& A, u32 i0, u32 mc, u32 p0, u32 kc, T* buf) noexcept -> void {
+    using S = GemmShape<T>;
+    let s0 = i64(A._step[0]);
+    let s1 = i64(A._step[1]);
+
+    for (mut ir = 0u; ir < mc; ir += S::$mr) {
+        let mr = ustd::min(S::$mr, mc - ir);
+        for (mut p = 0u; p < kc; ++p) {
+            let src = A._data + (i0 + ir) * s0 + (p0 + p) * s1;
+            for (mut r = 0u; r < mr; ++r) {
+                buf[r] = src[r * s0];
+            }
+            for (mut r = mr; r < S::$mr; ++r) {
+                buf[r] = T(0);
+            }
+            buf += S::$mr;
+        }
+    }
+}
+
+// B[p0:p0+kc, j0:j0+nc] -> $nr column slivers, zero padded
+template<class T>
+static fn _pack_b(const NDSlice<T, 2>& B, u32 p0, u32 kc, u32 j0, u32 nc, T* buf) noexcept -> void {
+    using S = GemmShape<T>;
+    let s0 = i64(B._step[0]);
+    let s1 = i64(B._step[1]);
+
+    for (mut jr = 0u; jr < nc; jr += S::$nr) {
+        let nr = ustd::min(S::$nr, nc - jr);
+        for (mut p = 0u; p < kc; ++p) {
+            let src = B._data + (p0 + p) * s0 + (j0 + jr) * s1;
+            for (mut j = 0u; j < nr; ++j) {
+                buf[j] = src[j * s1];
+            }
+            for (mut j = nr; j < S::$nr; ++j) {
+                buf[j] = T(0);
+            }
+            buf += S::$nr;
+        }
+    }
+}
+
+// C[0:mr, 0:nr] += alpha * pa * pb
+template<class T>
+static fn _gemm_micro(u32 kc, const T* pa, const T* pb, T* c, i64 cs0, i64 cs1, T alpha, u32 mr, u32 nr) noexcept -> void {
+    using S = GemmShape<T>;
+    using P = packet_t<T>;
+
+    P acc[S::$nr][S::$pa];
+    for (mut j = 0u; j < S::$nr; ++j) {
+        for (mut r = 0u; r < S::$pa; ++r) {
+            acc[j][r] = P::splat(T(0));
+        }
+    }
+
+    for (mut p = 0u; p < kc; ++p) {
+        P a[S::$pa];
+        for (mut r = 0u; r < S::$pa; ++r) {
+            a[r] = P::load(pa + r * P::$size);
+        }
+        for (mut j = 0u; j < S::$nr; ++j) {
+            let b = P::splat(pb[j]);
+            for (mut r = 0u; r < S::$pa; ++r) {
+                acc[j][r].mul_add(a[r], b);
+            }
+        }
+        pa += S::$mr;
+        pb += S::$nr;
+    }
+
+    let va = P::splat(alpha);
+    if (mr == S::$mr && nr == S::$nr && cs0 == 1) {
+        for (mut j = 0u; j < S::$nr; ++j) {
+            let col = c + j * cs1;
+            for (mut r = 0u; r < S::$pa; ++r) {
+                mut cv = P::load(col + r * P::$size);
+                cv.mul_add(acc[j][r], va);
+                cv.store(col + r * P::$size);
+            }
+        }
+        return;
+    }
+
+    // edge tile or strided C
+    for (mut j = 0u; j < nr; ++j) {
+        for (mut i = 0u; i < mr; ++i) {
+            c[i * cs0 + j * cs1] += alpha * acc[j][i / P::$size][i % P::$size];
+        }
+    }
+}
+
+template<class T>
+static fn _gemm(T alpha, const NDSlice<T, 2>& A, const NDSlice<T, 2>& B, T beta, NDSlice<T, 2>& C) noexcept -> void {
+    using S = GemmShape<T>;
+
+    let m = C._dims[0];
+    let n = C._dims[1];
+    let k = A._dims[1];
+    if (A._dims[0] != m || B._dims[0] != k || B._dims[1] != n) {
+        log::error("ustd::math::native::gemm(A={}x{}, B={}x{}, C={}x{}) -> Error(`dims not match`)",
+            A._dims[0], A._dims[1], B._dims[0], B._dims[1], m, n);
+        return;
+    }
+
+    if (beta == T(0)) {
+        C <<= T(0);
+    }
+    else if (beta != T(1)) {
+        C *= beta;
+    }
+
+    if (m == 0 || n == 0 || k == 0 || alpha == T(0)) {
+        return;
+    }
+
+    let par    = u64(m) * n * k >= $gemm_par_min;
+    let mb_cnt = (m + S::$mc - 1) / S::$mc;
+    let pb_cap = ((ustd::min(n, S::$nc) + S::$nr - 1) / S::$nr) * S::$nr * S::$kc;
+    mut pb     = mnew<T>(pb_cap);
+
+    let cs0 = i64(C._step[0]);
+    let cs1 = i64(C._step[1]);
+
+    for (mut jc = 0u; jc < n; jc += S::$nc) {
+        let nc = ustd::min(S::$nc, n - jc);
+
+        for (mut pc = 0u; pc < k; pc += S::$kc) {
+            let kc = ustd::min(S::$kc, k - pc);
+            _pack_b(B, pc, kc, jc, nc, pb);
+
+            // task: one $mc row block x one $ng column group of the panel
+            let ng_cnt = (nc + S::$ng - 1) / S::$ng;
+            let task   = [&](u32 id) {
+                let ib = id % mb_cnt;
+                let jg = id / mb_cnt;
+                let ic = ib * S::$mc;
+                let mc = ustd::min(S::$mc, m - ic);
+                let j0 = jg * S::$ng;
+                let j1 = ustd::min(j0 + S::$ng, nc);
+
+                mut pa = _gemm_buf<T>(S::$mc * S::$kc);
+                _pack_a(A, ic, mc, pc, kc, pa);
+
+                for (mut jr = j0; jr < j1; jr += S::$nr) {
+                    let nr = ustd::min(S::$nr, j1 - jr);
+                    let pbj = pb + jr * kc;
+
+                    for (mut ir = 0u; ir < mc; ir += S::$mr) {
+                        let mr = ustd::min(S::$mr, mc - ir);
+                        let c  = C._data + (ic + ir) * cs0 + (jc + jr) * cs1;
+                        _gemm_micro(kc, pa + ir * kc, pbj, c, cs0, cs1, alpha, mr, nr);
+                    }
+                }
+            };
+
+            let task_cnt = mb_cnt * ng_cnt;
+            if (!par || task_cnt == 1) {
+                for (mut id = 0u; id < task_cnt; ++id) {
+                    task(id);
+                }
+                continue;
+            }
+
+            thread::parallel_for(thread::Range{ 0, task_cnt }, 1, [&](thread::Range r) {
+                for (mut id = r._start; id < r._end; ++id) {
+                    task(u32(id));
+                }
+            });
+        }
+    }
+
+    mdel(pb);
+}
+#pragma endregion
+
+#pragma region lapack
+// lapack: block sizes of the blocked algorithms
+static constexpr let $lu_nb = 64u;
+static constexpr let $qr_nb = 32u;
+
+// A[i0:i0+m, j0:j0+n]
+template<class T>
+static fn _sub(const NDSlice<T, 2>& A, u32 i0, u32 j0, u32 m, u32 n) noexcept -> NDSlice<T, 2> {
+    let data = A._data + i64(i0) * A._step[0] + i64(j0) * A._step[1];
+    return NDSlice<T, 2>(data, u32x2{ m, n }, A._step);
+}
+
+// swap rows i and vp[i] of A, i in [i0, i1), forward or backward
+template<class T>
+static fn _laswp(NDSlice<T, 2>& A, const vu32& vp, u32 i0, u32 i1, bool forward) noexcept -> void {
+    let n = A._dims[1];
+    for (mut k = 0u; k < i1 - i0; ++k) {
+        let i = forward ? i0 + k : i1 - 1 - k;
+        let p = vp(i);
+        if (p == i) continue;
+        for (mut j = 0u; j < n; ++j) {
+            ustd::swap(A(i, j), A(p, j));
+        }
+    }
+}
+
+// B := inv(L) * B, L unit lower n x n
+template<class T>
+static fn _trsm_llu(const NDSlice<T, 2>& L, NDSlice<T, 2>& B) noexcept -> void {
+    let n = L._dims[0];
+    let r = B._dims[1];
+
+    for (mut i = 0u; i < n; i += $lu_nb) {
+        let ib = ustd::min($lu_nb, n - i);
+
+        _for_range(r, 64, [&](u32 c0, u32 c1) {
+            for (mut c = c0; c < c1; ++c) {
+                for (mut ii = 0u; ii < ib; ++ii) {
+                    let x = B(i + ii, c);
+                    for (mut kk = ii + 1; kk < ib; ++kk) {
+                        B(i + kk, c) -= L(i + kk, i + ii) * x;
+                    }
+                }
+            }
+        });
+
+        if (i + ib < n) {
+            mut B2 = _sub(B, i + ib, 0, n - i - ib, r);
+            _gemm(T(-1), _sub(L, i + ib, i, n - i - ib, ib), _sub(B, i, 0, ib, r), T(1), B2);
+        }
+    }
+}
+
+// B := inv(U) * B, U upper n x n
+template<class T>
+static fn _trsm_lun(const NDSlice<T, 2>& U, NDSlice<T, 2>& B) noexcept -> void {
+    let n = U._dims[0];
+    let r = B._dims[1];
+
+    for (mut e = n; e > 0; ) {
+        let ib = ustd::min($lu_nb, e);
+        let i  = e - ib;
+
+        _for_range(r, 64, [&](u32 c0, u32 c1) {
+            for (mut c = c0; c < c1; ++c) {
+                for (mut ii = ib; ii-- > 0; ) {
+                    let x = B(i + ii, c) / U(i + ii, i + ii);
+                    B(i + ii, c) = x;
+                    for (mut kk = 0u; kk < ii; ++kk) {
+                        B(i + kk, c) -= U(i + kk, i + ii) * x;
+                    }
+                }
+            }
+        });
+
+        if (i > 0) {
+            mut B0 = _sub(B, 0, 0, i, r);
+            _gemm(T(-1), _sub(U, 0, i, i, ib), _sub(B, i, 0, ib, r), T(1), B0);
+        }
+        e = i;
+    }
+}
+
+// unblocked LU of the panel A[j0:m, j0:j0+nb], pivots are absolute rows
+template<class T>
+static fn _getf2(NDSlice<T, 2>& A, vu32& vp, u32 j0, u32 nb) noexcept -> u32 {
+    let m    = A._dims[0];
+    mut info = 0u;
+
+    for (mut j = j0; j < j0 + nb; ++j) {
+        // pivot: max |A(i, j)|, i >= j
+        mut p = j;
+        mut v = ustd::abs(A(j, j));
+        for (mut i = j + 1; i < m; ++i) {
+            let a = ustd::abs(A(i, j));
+            if (a > v) {
+                p = i;
+                v = a;
+            }
+        }
+        vp(j) = p;
+
+        if (p != j) {
+            for (mut c = j0; c < j0 + nb; ++c) {
+                ustd::swap(A(j, c), A(p, c));
+            }
+        }
+
+        if (A(j, j) == T(0)) {
+            if (info == 0) info = j + 1;
+            continue;
+        }
+
+        let inv = T(1) / A(j, j);
+        for (mut i = j + 1; i < m; ++i) {
+            A(i, j) *= inv;
+        }
+
+        // A[j+1:m, j+1:j0+nb] -= A[j+1:m, j] * A[j, j+1:j0+nb]
+        for (mut c = j + 1; c < j0 + nb; ++c) {
+            let s = -A(j, c);
+            if (j + 1 < m) {
+                _axpy_raw(m - j - 1, s, &A(j + 1, j), A._step[0], &A(j + 1, c), A._step[0]);
+            }
+        }
+    }
+    return info;
+}
+
+// blocked right looking LU with partial pivoting
+template<class T>
+static fn _getrf(NDSlice<T, 2>& A, vu32& vp) noexcept -> u32 {
+    let m  = A._dims[0];
+    let n  = A._dims[1];
+    let mn = ustd::min(m, n);
+    if (vp._dims[0] < mn) {
+        log::error("ustd::math::native::getrf(A={}x{}, vp={}) -> Error(`vp too short`)", m, n, vp._dims[0]);
+        return 0;
+    }
+
+    mut info = 0u;
+    for (mut j = 0u; j < mn; j += $lu_nb) {
+        let jb = ustd::min($lu_nb, mn - j);
+
+        let panel_info = _getf2(A, vp, j, jb);
+        if (info == 0 && panel_info != 0) {
+            info = panel_info;
+        }
+
+        // apply the panel swaps left and right of the panel
+        if (j > 0) {
+            mut AL = _sub(A, 0, 0, m, j);
+            _laswp(AL, vp, j, j + jb, true);
+        }
+
+        if (j + jb < n) {
+            mut AR = _sub(A, 0, j + jb, m, n - j - jb);
+            _laswp(AR, vp, j, j + jb, true);
+
+            // U12 = inv(L11) * A12
+            mut A12 = _sub(A, j, j + jb, jb, n - j - jb);
+            _trsm_llu(_sub(A, j, j, jb, jb), A12);
+
+            // A22 -= A21 * U12
+            if (j + jb < m) {
+                mut A22 = _sub(A, j + jb, j + jb, m - j - jb, n - j - jb);
+                _gemm(T(-1), _sub(A, j + jb, j, m - j - jb, jb), A12, T(1), A22);
+            }
+        }
+    }
+    return info;
+}
+
+// A*X = B, A factored by getrf
+template<class T>
+static fn _getrs(const NDSlice<T, 2>& A, const vu32& vp, NDSlice<T, 2>& B) noexcept -> void {
+    let n = A._dims[0];
+    if (A._dims[1] != n || B._dims[0] != n || vp._dims[0] < n) {
+        log::error("ustd::math::native::getrs(A={}x{}, vp={}, B={}x{}) -> Error(`dims not match`)", A._dims[0], A._dims[1], vp._dims[0], B._dims[0], B._dims[1]);
+        return;
+    }
+
+    _laswp(B, vp, 0, n, true);
+    _trsm_llu(A, B);
+    _trsm_lun(A, B);
+}
+
+// inv(A) = inv(U) * inv(L) * P, solved column block wise against I
+template<class T>
+static fn _getri(NDSlice<T, 2>& A, const vu32& vp) noexcept -> u32 {
+    let n = A._dims[0];
+    if (A._dims[1] != n) {
+        log::error("ustd::math::native::getri(A={}x{}) -> Error(`A not square`)", A._dims[0], A._dims[1]);
+        return 0;
+    }
+
+    for (mut i = 0u; i < n; ++i) {
+        if (A(i, i) == T(0)) {
+            return i + 1;
+        }
+    }
+
+    mut X = NDArray<T, 2>::with_dims({ n, n });
+    X <<= T(0);
+    for (mut i = 0u; i < n; ++i) {
+        X(i, i) = T(1);
+    }
+
+    _getrs(A, vp, X);
+    A <<= X;
+    return 0;
+}
+
+// Householder reflector of x = [alpha; v]: H*x = [beta; 0], H = I - tau*[1; v]*[1; v]'
+template<class T>
+static fn _larfg(T& alpha, u32 n, T* v, i32 dv) noexcept -> T {
+    let xnorm = n == 0 ? T(0) : _nrm2(NDSlice<T, 1>(v, vec<u32, 1>{ n }, vec<i32, 1>{ dv }));
+    if (xnorm == T(0)) {
+        return T(0);
+    }
+
+    let norm = math::sqrt(alpha * alpha + xnorm * xnorm);
+    let beta = alpha >= T(0) ? -norm : norm;
+    let tau  = (beta - alpha) / beta;
+    let scal = T(1) / (alpha - beta);
+    for (mut i = 0u; i < n; ++i) {
+        v[i64(i) * dv] *= scal;
+    }
+    alpha = beta;
+    return tau;
+}
+
+// unblocked QR of the panel A[j0:m, j0:j0+nb]
+template<class T>
+static fn _geqr2(NDSlice<T, 2>& A, NDSlice<T, 1>& tau, u32 j0, u32 nb) noexcept -> void {
+    let m  = A._dims[0];
+    let s0 = A._step[0];
+
+    for (mut j = j0; j < j0 + nb; ++j) {
+        let tail = m - j - 1;
+        let vtau = _larfg(A(j, j), tail, tail == 0 ? nullptr : &A(j + 1, j), s0);
+        tau(j) = vtau;
+        if (vtau == T(0)) continue;
+
+        // A[j:m, c] -= tau * v * (v' * A[j:m, c]), v = [1; A[j+1:m, j]]
+        for (mut c = j + 1; c < j0 + nb; ++c) {
+            mut s = A(j, c);
+            if (tail != 0) {
+                s += _dot_raw(tail, &A(j + 1, j), s0, &A(j + 1, c), s0);
+            }
+            s *= vtau;
+            A(j, c) -= s;
+            if (tail != 0) {
+                _axpy_raw(tail, -s, &A(j + 1, j), s0, &A(j + 1, c), s0);
+            }
+        }
+    }
+}
+
+// blocked Householder QR, compact WY: H1*...*Hk = I - V*T*V'
+template<class T>
+static fn _geqrf(NDSlice<T, 2>& A, NDSlice<T, 1>& tau) noexcept -> void {
+    let m = A._dims[0];
+    let n = A._dims[1];
+    let k = ustd::min(m, n);
+    if (tau._dims[0] < k) {
+        log::error("ustd::math::native::geqrf(A={}x{}, tau={}) -> Error(`tau too short`)", m, n, tau._dims[0]);
+        return;
+    }
+
+    for (mut j = 0u; j < k; j += $qr_nb) {
+        let jb = ustd::min($qr_nb, k - j);
+        _geqr2(A, tau, j, jb);
+
+        if (j + jb >= n) {
+            continue;
+        }
+
+        // V: unit lower trapezoid of the panel, made explicit for gemm
+        let mv = m - j;
+        mut V  = NDArray<T, 2>::with_dims({ mv, jb });
+        for (mut c = 0u; c < jb; ++c) {
+            for (mut r = 0u; r < mv; ++r) {
+                V(r, c) = r < c ? T(0) : r == c ? T(1) : A(j + r, j + c);
+            }
+        }
+
+        // T: upper triangular, T(i,i) = tau_i, T[0:i, i] = -tau_i * T[0:i, 0:i] * V[:, 0:i]' * v_i
+        mut Tm = NDArray<T, 2>::with_dims({ jb, jb });
+        Tm <<= T(0);
+        for (mut i = 0u; i < jb; ++i) {
+            let ti = tau(j + i);
+            Tm(i, i) = ti;
+
+            T w[$qr_nb];
+            for (mut c = 0u; c < i; ++c) {
+                w[c] = _dot_raw(mv - i, &V(i, c), V._step[0], &V(i, i), V._step[0]);
+            }
+            for (mut r = 0u; r < i; ++r) {
+                mut acc = T(0);
+                for (mut c = r; c < i; ++c) {
+                    acc += Tm(r, c) * w[c];
+                }
+                Tm(r, i) = -ti * acc;
+            }
+        }
+
+        // C := H' * C = C - V * (T' * (V' * C)), C = A[j:m, j+jb:n]
+        let nc = n - j - jb;
+        mut C  = _sub(A, j, j + jb, mv, nc);
+        mut W  = NDArray<T, 2>::with_dims({ jb, nc });
+        mut W2 = NDArray<T, 2>::with_dims({ jb, nc });
+
+        let Vt = NDSlice<T, 2>(V._data, u32x2{ jb, mv }, i32x2{ V._step[1], V._step[0] });
+        let Tt = NDSlice<T, 2>(Tm._data, u32x2{ jb, jb }, i32x2{ Tm._step[1], Tm._step[0] });
+        _gemm(T(1), Vt, C, T(0), W);
+        _gemm(T(1), Tt, W, T(0), W2);
+        _gemm(T(-1), V, W2, T(1), C);
+    }
+}
+#pragma endregion
+
+#pragma region export
+pub fn amax(vf32 x) noexcept -> u32 { return _iabs(x, true);  }
+pub fn amax(vf64 x) noexcept -> u32 { return _iabs(x, true);  }
+
+pub fn amin(vf32 x) noexcept -> u32 { return _iabs(x, false); }
+pub fn amin(vf64 x) noexcept -> u32 { return _iabs(x, false); }
+
+pub fn asum(vf32 x) noexcept -> f32 { return _asum(x); }
+pub fn asum(vf64 x) noexcept -> f64 { return _asum(x); }
+
+pub fn axpy(f32 alpha, vf32 x, vf32 y) noexcept -> void { _axpy(alpha, x, y); }
+pub fn axpy(f64 alpha, vf64 x, vf64 y) noexcept -> void { _axpy(alpha, x, y); }
+
+pub fn copy(vf32 x, vf32 y) noexcept -> void { y <<= x; }
+pub fn copy(vf64 x, vf64 y) noexcept -> void { y <<= x; }
+
+pub fn dot(vf32 x, vf32 y) noexcept -> f32 { return _dot(x, y); }
+pub fn dot(vf64 x, vf64 y) noexcept -> f64 { return _dot(x, y); }
+
+pub fn nrm2(vf32 x) noexcept -> f32 { return _nrm2(x); }
+pub fn nrm2(vf64 x) noexcept -> f64 { return _nrm2(x); }
+
+pub fn rot(vf32 x, vf32 y, f32x4 h) noexcept -> void { _rot(x, y, h); }
+pub fn rot(vf64 x, vf64 y, f64x4 h) noexcept -> void { _rot(x, y, h); }
+
+pub fn scal(f32 alpha, vf32 x) noexcept -> void { x *= alpha; }
+pub fn scal(f64 alpha, vf64 x) noexcept -> void { x *= alpha; }
+
+pub fn swap(vf32 x, vf32 y) noexcept -> void { _swap(x, y); }
+pub fn swap(vf64 x, vf64 y) noexcept -> void { _swap(x, y); }
+
+pub fn gemv(f32 alpha, mf32 A, vf32 x, f32 beta, vf32 y) noexcept -> void { _gemv(alpha, A, x, beta, y); }
+pub fn gemv(f64 alpha, mf64 A, vf64 x, f64 beta, vf64 y) noexcept -> void { _gemv(alpha, A, x, beta, y); }
+
+pub fn ger(f32 alpha, vf32 x, vf32 y, mf32 A) noexcept -> void { _ger(alpha, x, y, A); }
+pub fn ger(f64 alpha, vf64 x, vf64 y, mf64 A) noexcept -> void { _ger(alpha, x, y, A); }
+
+pub fn gemm(f32 alpha, mf32 A, mf32 B, f32 beta, mf32 C) noexcept -> void { _gemm(alpha, A, B, beta, C); }
+pub fn gemm(f64 alpha, mf64 A, mf64 B, f64 beta, mf64 C) noexcept -> void { _gemm(alpha, A, B, beta, C); }
+
+pub fn getrf(mf32 A, vu32 vp) noexcept -> u32 { return _getrf(A, vp); }
+pub fn getrf(mf64 A, vu32 vp) noexcept -> u32 { return _getrf(A, vp); }
+
+pub fn getrs(mf32 A, vu32 vp, mf32 B) noexcept -> void { _getrs(A, vp, B); }
+pub fn getrs(mf64 A, vu32 vp, mf64 B) noexcept -> void { _getrs(A, vp, B); }
+
+pub fn getri(mf32 A, vu32 vp) noexcept -> u32 { return _getri(A, vp); }
+pub fn getri(mf64 A, vu32 vp) noexcept -> u32 { return _getri(A, vp); }
+
+pub fn geqrf(mf32 A, vf32 tau) noexcept -> void { _geqrf(A, tau); }
+pub fn geqrf(mf64 A, vf64 tau) noexcept -> void { _geqrf(A, tau); }
+#pragma endregion
+
+template<class T>
+static fn _gemm_ref(T alpha, const NDSlice<T, 2>& A, const NDSlice<T, 2>& B, T beta, NDSlice<T, 2>& C) -> void {
+    for (mut i = 0u; i < C._dims[0]; ++i) {
+        for (mut j = 0u; j < C._dims[1]; ++j) {
+            mut acc = T(0);
+            for (mut p = 0u; p < A._dims[1]; ++p) {
+                acc += A(i, p) * B(p, j);
+            }
+            C(i, j) = alpha * acc + beta * C(i, j);
+        }
+    }
+}
+
+template<class T>
+static fn _test_gemm(u32 m, u32 n, u32 k, T eps) -> void {
+    mut A  = NDArray<T, 2>::with_dims({ m, k });
+    mut Bt = NDArray<T, 2>::with_dims({ n, k });
+    mut C0 = NDArray<T, 2>::with_dims({ m, n });
+    mut C1 = NDArray<T, 2>::with_dims({ m, n });
+
+    A  <<= vline(T(0.01), T(-0.02));
+    Bt <<= vline(T(0.03), T(0.01));
+    C0 <<= vline(T(1), T(2));
+    C1 <<= vline(T(1), T(2));
+
+    // B = Bt', row major view
+    let B = NDSlice<T, 2>(Bt._data, vec<u32, 2>{ k, n }, vec<i32, 2>{ i32(n), 1 });
+
+    _gemm_ref(T(0.5), A, B, T(2), C0);
+    native::gemm(T(0.5), A, B, T(2), C1);
+
+    for (mut i = 0u; i < m; ++i) {
+        for (mut j = 0u; j < n; ++j) {
+            let d = ustd::abs(C0(i, j) - C1(i, j));
+            let s = ustd::max(ustd::abs(C0(i, j)), T(1));
+            assert_eq(d <= eps * s, true);
+        }
+    }
+}
+
+unittest(native_blas1)
+{
+    mut x = NDArray<f64>::with_dims({ 1001 });
+    mut y = NDArray<f64>::with_dims({ 1001 });
+    x <<= vline(1.0);
+    y <<= 2.0;
+
+    assert_eq(native::dot(x, y), 1000.0 * 1001.0);
+    assert_eq(native::asum(x), 1000.0 * 1001.0 / 2);
+    assert_eq(native::amax(x), 1000u);
+
+    native::axpy(0.5, x, y);
+    assert_eq(y(10), 7.0);
+
+    mut v = NDArray<f32>::with_dims({ 2 });
+    v(0u) = 3.f;
+    v(1u) = 4.f;
+    assert_eq(native::nrm2(v), 5.f);
+}
+
+unittest(native_gemv)
+{
+    let m = 37u;
+    let n = 53u;
+    mut A = NDArray<f64, 2>::with_dims({ m, n });
+    mut x = NDArray<f64>::with_dims({ n });
+    mut y = NDArray<f64>::with_dims({ m });
+
+    A <<= vline(1.0, 0.5);
+    x <<= 1.0;
+    y <<= 1.0;
+    native::gemv(2.0, A, x, 3.0, y);
+
+    for (mut i = 0u; i < m; ++i) {
+        mut acc = 0.0;
+        for (mut j = 0u; j < n; ++j) {
+            acc += A(i, j);
+        }
+        assert_eq(y(i), 2.0 * acc + 3.0);
+    }
+
+    // row major view of A'
+    let At = NDSlice<f64, 2>(A._data, u32x2{ n, m }, i32x2{ i32(m), 1 });
+    mut z  = NDArray<f64>::with_dims({ n });
+    mut w  = NDArray<f64>::with_dims({ m });
+    w <<= 1.0;
+    native::gemv(1.0, At, w, 0.0, z);
+    for (mut j = 0u; j < n; ++j) {
+        mut acc = 0.0;
+        for (mut i = 0u; i < m; ++i) {
+            acc += A(i, j);
+        }
+        assert_eq(z(j), acc);
+    }
+}
+
+unittest(native_gemm)
+{
+    _test_gemm<f64>(1, 1, 1, 1e-12);
+    _test_gemm<f64>(37, 29, 301, 1e-12);
+    _test_gemm<f32>(131, 67, 19, 1e-4f);
+    _test_gemm<f32>(300, 700, 260, 1e-4f);
+
+    let n = 1024u;
+    mut A = NDArray<f32, 2>::with_dims({ n, n });
+    mut B = NDArray<f32, 2>::with_dims({ n, n });
+    mut C = NDArray<f32, 2>::with_dims({ n, n });
+    A <<= 1.f;
+    B <<= 1.f;
+
+    let t0 = time::Instant::now();
+    native::gemm(1.f, A, B, 0.f, C);
+    let t1 = time::Instant::now();
+
+    let dur = t1 - t0;
+    let gflops = 2.0 * n * n * n / dur.total_secs() * 1e-9;
+    log::info("ustd::math::native::gemm[{}x{}x{}]: {}, {} GFLOPS", n, n, n, dur, gflops);
+    assert_eq(C(n - 1, n - 1), f32(n));
+}
+
+
+// diagonally heavy, so the pivots move rows but stay well conditioned
+template<class T>
+static fn _test_matrix(u32 n) -> NDArray<T, 2> {
+    mut A = NDArray<T, 2>::with_dims({ n, n });
+    A <<= vline(T(0.003), T(-0.007));
+    for (mut i = 0u; i < n; ++i) {
+        A(i, (i * 7 + 3) % n) += T(n);
+    }
+    return A;
+}
+
+template<class T>
+static fn _test_getrf(u32 n, T eps) -> void {
+    mut A  = _test_matrix<T>(n);
+    mut LU = _test_matrix<T>(n);
+    mut vp = NDArray<u32>::with_dims({ n });
+    assert_eq(native::getrf(LU, vp), 0u);
+
+    // A*x = b, x = 1
+    mut x = NDArray<T, 2>::with_dims({ n, 1 });
+    mut b = NDArray<T, 2>::with_dims({ n, 1 });
+    x <<= T(1);
+    _gemm_ref(T(1), A, x, T(0), b);
+    native::getrs(LU, vp, b);
+    for (mut i = 0u; i < n; ++i) {
+        assert_eq(ustd::abs(b(i, 0u) - T(1)) <= eps, true);
+    }
+
+    // A*inv(A) = I
+    assert_eq(native::getri(LU, vp), 0u);
+    mut I = NDArray<T, 2>::with_dims({ n, n });
+    native::gemm(T(1), A, LU, T(0), I);
+    for (mut i = 0u; i < n; ++i) {
+        for (mut j = 0u; j < n; ++j) {
+            let e = i == j ? T(1) : T(0);
+            assert_eq(ustd::abs(I(i, j) - e) <= eps, true);
+        }
+    }
+}
+
+template<class T>
+static fn _test_geqrf(u32 m, u32 n, T eps) -> void {
+    mut A   = NDArray<T, 2>::with_dims({ m, n });
+    mut QR  = NDArray<T, 2>::with_dims({ m, n });
+    mut tau = NDArray<T>::with_dims({ ustd::min(m, n) });
+    A  <<= vline(T(0.01), T(0.02));
+    for (mut i = 0u; i < ustd::min(m, n); ++i) {
+        A(i, i) += T(1);
+    }
+    QR <<= A;
+    native::geqrf(QR, tau);
+
+    // Q is orthogonal: A'*A = R'*R
+    mut R = NDArray<T, 2>::with_dims({ n, n });
+    R <<= T(0);
+    for (mut j = 0u; j < n; ++j) {
+        for (mut i = 0u; i <= ustd::min(j, m - 1); ++i) {
+            R(i, j) = QR(i, j);
+        }
+    }
+
+    let At = NDSlice<T, 2>(A._data, u32x2{ n, m }, i32x2{ A._step[1], A._step[0] });
+    let Rt = NDSlice<T, 2>(R._data, u32x2{ n, n }, i32x2{ R._step[1], R._step[0] });
+    mut G0 = NDArray<T, 2>::with_dims({ n, n });
+    mut G1 = NDArray<T, 2>::with_dims({ n, n });
+    _gemm_ref(T(1), At, A, T(0), G0);
+    _gemm_ref(T(1), Rt, R, T(0), G1);
+
+    for (mut i = 0u; i < n; ++i) {
+        for (mut j = 0u; j < n; ++j) {
+            let s = ustd::max(ustd::abs(G0(i, j)), T(1));
+            assert_eq(ustd::abs(G0(i, j) - G1(i, j)) <= eps * s, true);
+        }
+    }
+}
+
+unittest(native_getrf)
+{
+    _test_getrf<f64>(1, 1e-12);
+    _test_getrf<f64>(200, 1e-10);
+    _test_getrf<f32>(150, 1e-3f);
+
+    // singular: second column is zero
+    mut S  = NDArray<f64, 2>::with_dims({ 3, 3 });
+    mut vp = NDArray<u32>::with_dims({ 3 });
+    S <<= 1.0;
+    for (mut i = 0u; i < 3; ++i) {
+        S(i, 1u) = 0.0;
+    }
+    assert_eq(native::getrf(S, vp), 2u);
+}
+
+unittest(native_geqrf)
+{
+    _test_geqrf<f64>(5, 3, 1e-12);
+    _test_geqrf<f64>(120, 90, 1e-10);
+    _test_geqrf<f32>(70, 70, 1e-3f);
+}
+
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "ustd/core.h"
+#include "ustd/math/ndslice.h"
+
+namespace ustd::math
+{
+
+using vf32 = NDSlice<f32, 1>;
+using vf64 = NDSlice<f64, 1>;
+using mf32 = NDSlice<f32, 2>;
+using mf64 = NDSlice<f64, 2>;
+using vu32 = NDSlice<u32, 1>;
+
+// native: built-in kernels behind `blas`, any strides, no external runtime
+namespace native
+{
+// blas: 1
+pub fn amax(vf32 x) noexcept -> u32;
+pub fn amax(vf64 x) noexcept -> u32;
+
+pub fn amin(vf32 x) noexcept -> u32;
+pub fn amin(vf64 x) noexcept -> u32;
+
+pub fn asum(vf32 x) noexcept -> f32;
+pub fn asum(vf64 x) noexcept -> f64;
+
+pub fn axpy(f32 alpha, vf32 x, vf32 y) noexcept -> void;
+pub fn axpy(f64 alpha, vf64 x, vf64 y) noexcept -> void;
+
+pub fn copy(vf32 x, vf32 y) noexcept -> void;
+pub fn copy(vf64 x, vf64 y) noexcept -> void;
+
+pub fn dot(vf32 x, vf32 y) noexcept -> f32;
+pub fn dot(vf64 x, vf64 y) noexcept -> f64;
+
+pub fn nrm2(vf32 x) noexcept -> f32;
+pub fn nrm2(vf64 x) noexcept -> f64;
+
+pub fn rot(vf32 x, vf32 y, f32x4 h) noexcept -> void;
+pub fn rot(vf64 x, vf64 y, f64x4 h) noexcept -> void;
+
+pub fn scal(f32 alpha, vf32 x) noexcept -> void;
+pub fn scal(f64 alpha, vf64 x) noexcept -> void;
+
+pub fn swap(vf32 x, vf32 y) noexcept -> void;
+pub fn swap(vf64 x, vf64 y) noexcept -> void;
+
+// blas: 2
+// y := alpha*A*x + beta*y
+pub fn gemv(f32 alpha, mf32 A, vf32 x, f32 beta, vf32 y) noexcept -> void;
+pub fn gemv(f64 alpha, mf64 A, vf64 x, f64 beta, vf64 y) noexcept -> void;
+
+// A := alpha*x*y' + A
+pub fn ger(f32 alpha, vf32 x, vf32 y, mf32 A) noexcept -> void;
+pub fn ger(f64 alpha, vf64 x, vf64 y, mf64 A) noexcept -> void;
+
+// blas: 3
+// C := alpha*A*B + beta*C, packed and register blocked, threaded on the shared pool
+pub fn gemm(f32 alpha, mf32 A, mf32 B, f32 beta, mf32 C) noexcept -> void;
+pub fn gemm(f64 alpha, mf64 A, mf64 B, f64 beta, mf64 C) noexcept -> void;
+
+// lapack: blocked, trailing updates run on `gemm`
+// A = P*L*U, row i was swapped with row vp(i) (0-based); returns 0, or i+1 if U(i,i) == 0
+pub fn getrf(mf32 A, vu32 vp) noexcept -> u32;
+pub fn getrf(mf64 A, vu32 vp) noexcept -> u32;
+
+// B := inv(A)*B, A and vp from getrf
+pub fn getrs(mf32 A, vu32 vp, mf32 B) noexcept -> void;
+pub fn getrs(mf64 A, vu32 vp, mf64 B) noexcept -> void;
+
+// A := inv(A), A and vp from getrf; returns 0, or i+1 if U(i,i) == 0
+pub fn getri(mf32 A, vu32 vp) noexcept -> u32;
+pub fn getri(mf64 A, vu32 vp) noexcept -> u32;
+
+// A = Q*R, R in the upper triangle, Householder vectors below it, Q = H(0)*...*H(k-1)
+pub fn geqrf(mf32 A, vf32 tau) noexcept -> void;
+pub fn geqrf(mf64 A, vf64 tau) noexcept -> void;
+}
+
+}
@@ -28,4 +28,27 @@ unittest(ndarray_v3)
     assert_eq(a.dims(), u32x3{ 8u, 8u, 8u });
 }
 
+unittest(ndarray_alloc)
+{
+    mut a = NDArray<f32, 2>::with_dims({ 7, 5 });
+    assert_eq(a.align() >= $mem_align, false);
+    assert_eq(u64(a._data) % $mem_align, u64(0));
+
+    // padded: every column starts on a cache line
+    mut b = NDArray<f32, 2>::with_dims({ 7, 5 }, NDAlloc::padded());
+    assert_eq(b.step(), i32x2{ 1, 16 });
+    assert_eq(b.align() >= $mem_align, true);
+    b(6u, 4u) = 1.0f;
+
+    // 4KB columns get one more cache line
+    mut c = NDArray<f32, 2>::with_dims({ 1024, 4 }, NDAlloc::padded());
+    assert_eq(c.step(), i32x2{ 1, 1040 });
+
+    mut d = NDArray<f64, 2>::with_dims({ 1024, 1024 }, NDAlloc::huge());
+    assert_eq(d.align() >= $mem_align, true);
+    d(1023u, 1023u) = 1.0;
+    d.resize({ 8, 8 });
+    assert_eq(d._alloc._huge, true);
+}
+
 }
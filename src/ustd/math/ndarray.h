@@ -6,14 +6,37 @@
 namespace ustd::math
 {
 
+// NDArray: how the buffer is allocated
+struct NDAlloc
+{
+    u64     _align;     // bytes, power of 2, the start of every line along dim 0 when padded
+    bool    _huge;      // 2MB transparent huge pages for buffers of at least $mem_huge_page
+    bool    _pad;       // pad dim 0 to `_align`, and by one more `_align` on 4KB strides (cache set aliasing)
+
+    static fn dense() noexcept -> NDAlloc {
+        return { $mem_align, false, false };
+    }
+
+    static fn padded(u64 align = $mem_align) noexcept -> NDAlloc {
+        return { align, false, true };
+    }
+
+    static fn huge(u64 align = $mem_align) noexcept -> NDAlloc {
+        return { align, true, false };
+    }
+};
+
 template<typename T, u32 N = 1>
 class NDArray: public NDSlice<T, N>
 {
 public:
     using base   = NDSlice<T, N>;
     using u32xN  = typename base::u32xN;
+    using i32xN  = typename base::i32xN;
 
-    NDArray(NDArray&& other) noexcept : base(other) {
+    NDAlloc _alloc;
+
+    NDArray(NDArray&& other) noexcept : base(other), _alloc(other._alloc) {
         other._data = nullptr;
     }
 
@@ -21,15 +44,20 @@ public:
         if (base::_data == nullptr) {
             return;
         }
-        ustd::mdel(base::_data);
+        ustd::mdel_aligned(base::_data);
     }
 
+    // ctor: dense, $mem_align aligned
     static fn with_dims(const u32xN& dims) noexcept -> NDArray {
-        return NDArray(dims);
+        return NDArray(dims, NDAlloc::dense());
+    }
+
+    static fn with_dims(const u32xN& dims, const NDAlloc& alloc) noexcept -> NDArray {
+        return NDArray(dims, alloc);
     }
 
     fn resize(const u32xN& dims) -> NDArray& {
-        mut tmp = NDArray(dims);
+        mut tmp = NDArray(dims, _alloc);
         ustd::swap(*this, tmp);
         return *this;
     }
@@ -40,14 +68,38 @@ public:
     }
 
 protected:
-    explicit NDArray(const u32xN& dims) noexcept : base(nullptr, dims) {
+    explicit NDArray(const u32xN& dims, const NDAlloc& alloc) noexcept : base(nullptr, dims), _alloc(alloc) {
         let cnt = base::count();
-        if (cnt != 0) {
-            base::_data = ustd::mnew<T>(dims);
+        if (cnt == 0) {
+            return;
+        }
+
+        if constexpr (N > 1) {
+            if (alloc._pad) {
+                base::_step = _padded_step(dims, alloc._align);
+            }
         }
+
+        let len = u64(base::_step[N - 1]) * dims[N - 1];
+        base::_data = ustd::mnew_aligned<T>(len, alloc._align, alloc._huge);
     }
-};
 
+    static fn _padded_step(const u32xN& dims, u64 align) noexcept -> i32xN {
+        let elems = ustd::max(u32(align / sizeof(T)), 1u);
 
-}
+        mut lead = (dims[0] + elems - 1) / elems * elems;
+        if (u64(lead) * sizeof(T) % 4096 == 0) {
+            lead += elems;
+        }
+
+        mut res = i32xN{};
+        res[0] = 1;
+        res[1] = i32(lead);
+        for (mut i = 2u; i < N; ++i) {
+            res[i] = res[i - 1] * i32(dims[i - 1]);
+        }
+        return res;
+    }
+};
 
+}
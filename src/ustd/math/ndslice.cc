@@ -0,0 +1,55 @@
+#include "config.inl"
+
+namespace ustd::math
+{
+
+pub fn eval_opts() noexcept -> EvalOpts& {
+    static mut res = EvalOpts{
+        1u << 16,   // _par_min
+        256u,       // _tile_inner
+        64u << 10,  // _tile_bytes
+    };
+    return res;
+}
+
+unittest(ndslice_eval)
+{
+    let n = 1024u;
+    mut a = NDArray<f32, 2>::with_dims({ n, n });
+    mut b = NDArray<f32, 2>::with_dims({ n, n });
+    mut c = NDArray<f32, 2>::with_dims({ n, n });
+
+    b <<= vline(1.f, 1000.f);
+    c <<= 1.f;
+
+    let t0 = time::Instant::now();
+    a <<= 2.f * b + c;
+    let t1 = time::Instant::now();
+    log::info("ustd::math::eval: a <<= 2.f*b + c, {}x{}: {}", n, n, t1 - t0);
+
+    for (mut i = 0u; i < n; i += 7) {
+        for (mut j = 0u; j < n; j += 5) {
+            assert_eq(a(i, j), 2.f * (f32(i) + 1000.f * f32(j)) + 1.f);
+        }
+    }
+
+    // transposed operand: bt(i, j) == b(j, i)
+    mut bt = NDSlice<f32, 2>(b._data, u32x2{ n, n }, i32x2{ i32(n), 1 });
+    let t2 = time::Instant::now();
+    a <<= 2.f * bt + c;
+    let t3 = time::Instant::now();
+    log::info("ustd::math::eval: a <<= 2.f*b^T + c, {}x{}: {}", n, n, t3 - t2);
+
+    for (mut i = 0u; i < n; i += 7) {
+        for (mut j = 0u; j < n; j += 5) {
+            assert_eq(a(i, j), 2.f * (f32(j) + 1000.f * f32(i)) + 1.f);
+        }
+    }
+
+    // transposed destination: the loop order follows its strides
+    mut at = NDSlice<f32, 2>(a._data, u32x2{ n, n }, i32x2{ i32(n), 1 });
+    at += 1.f;
+    assert_eq(a(3, 5), 2.f * (5.f + 3000.f) + 2.f);
+}
+
+}
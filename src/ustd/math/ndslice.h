@@ -2,6 +2,7 @@
 
 #include "ustd/math/types.h"
 #include "ustd/core/fmt.h"
+#include "ustd/thread/parallel.h"
 
 namespace ustd::math
 {
@@ -115,6 +116,46 @@ struct NDSlice: public ndvec_t<T,N>
 
 #pragma endregion
 
+#pragma region packet
+    template<class V>
+    constexpr static let $packet = $is_same<T, V> && trait<T>::$num;
+
+    // property[r]: dim 0 is dense
+    fn is_packed() const noexcept -> bool {
+        return _step[0] == 1 || _dims[0] <= 1;
+    }
+
+    // property[r]: alignment in bytes of every line along dim 0, 0 when empty
+    //  - kernels may use aligned packets from the first element on when it is >= P::$bytes
+    fn align() const noexcept -> u64 {
+        if (_data == nullptr) {
+            return 0;
+        }
+
+        mut bits = u64(_data);
+        for (mut i = 1u; i < N; ++i) {
+            if (_dims[i] > 1) {
+                bits |= u64(i64(_step[i]) * i64(sizeof(T)));
+            }
+        }
+        return bits & (~bits + 1);
+    }
+
+    // method: load P::$size elements starting at (x, ...) along dim 0
+    template<class P, typename ...R, class=when<sizeof...(R)==N> >
+    fn load_packet(R ...idxs) const noexcept -> P {
+        let offset = _get_offset(seq_t<N>{}, idxs...);
+        return P::load(_data + offset);
+    }
+
+    // method: store P::$size elements starting at (x, ...) along dim 0
+    template<class P, typename ...R, class=when<sizeof...(R)==N> >
+    fn store_packet(const P& val, R ...idxs) noexcept -> void {
+        let offset = _get_offset(seq_t<N>{}, idxs...);
+        val.store(_data + offset);
+    }
+#pragma endregion
+
 private:
     /* method: access */
     template<u32 ...I, typename ...U>
@@ -191,52 +232,174 @@ fn trait_sfmt(Formatter& fmt, const NDSlice<T,2>& v) -> void {
     fmt.push_str("]");
 }
 
-template<class O, class T, class F>
-fn foreach(NDSlice<T,1>& dst, const F& src) -> void {
-    let dims = dst.dims();
-    for(mut x = 0u; x < dims.x; ++x) {
-        dst(x) = src(x);
-    }
+#pragma region eval
+// eval: options of the assignment engine
+struct EvalOpts
+{
+    u64 _par_min;       // elements, smaller assignments run on the calling thread
+    u32 _tile_inner;    // elements of a tile along the innermost loop
+    u32 _tile_bytes;    // bytes of a tile in `dst`
+};
+
+// options used by every NDSlice assignment, safe to change between assignments
+pub fn eval_opts() noexcept -> EvalOpts&;
+
+template<u32 ...I, class F, class V>
+fn _idx_apply(immut_t<u32, I...>, F&& f, const V& idx) noexcept -> decltype(auto) {
+    return f(idx[I]...);
 }
 
-template<class O, class T, class F>
-fn foreach(NDSlice<T,2>& dst, const F& src) -> void {
-    let dims = dst.dims();
-    
-    for(mut x = 0u; x < dims.x; ++x) {
-        for(mut y = 0u; y < dims.y; ++y) {
-            dst(x, y) = src(x, y);
+// row: dst(idx) @= src(idx) for idx[d0] in [x0, x1)
+template<class O, class T, u32 N, class F>
+fn eval_row(NDSlice<T,N>& dst, const F& src, vec<u32,N> idx, u32 d0, u32 x0, u32 x1) noexcept -> void {
+    mut x = x0;
+
+    // packets run along dim 0 only, the other dims are never dense
+    if constexpr ($packet_op<O> && NDSlice<T,N>::template $packet<T> && F::template $packet<T>) {
+        using P = packet_t<T>;
+
+        if (d0 == 0 && dst.is_packed() && src.is_packed()) {
+            for (; x + P::$size <= x1; x += P::$size) {
+                idx[0] = x;
+                let s = _idx_apply(seq_t<N>{}, [&](auto ...i) { return src.template load_packet<P>(i...); }, idx);
+
+                if constexpr ($is_same<O, ops::SetTo>) {
+                    _idx_apply(seq_t<N>{}, [&](auto ...i) { dst.store_packet(s, i...); }, idx);
+                }
+                else {
+                    mut d = _idx_apply(seq_t<N>{}, [&](auto ...i) { return dst.template load_packet<P>(i...); }, idx);
+                    O()(d, s);
+                    _idx_apply(seq_t<N>{}, [&](auto ...i) { dst.store_packet(d, i...); }, idx);
+                }
+            }
         }
     }
+
+    for (; x < x1; ++x) {
+        idx[d0] = x;
+        _idx_apply(seq_t<N>{}, [&](auto ...i) { O()(dst(i...), src(i...)); }, idx);
+    }
 }
 
-template<class O, class T, class F>
-fn foreach(NDSlice<T,3>& dst, const F& src) -> void {
-    let dims = dst.dims();
-    
-    for(mut x = 0u; x < dims.x; ++x) {
-        for(mut y = 0u; y < dims.y; ++y) {
-            for(mut z = 0u; z < dims.z; ++z) {
-                dst(x, y, z) = src(x, y, z);
+// plan: loop order and tiling of an assignment
+//  - ord[0] is the dim with the smallest `dst` stride, it runs innermost
+//  - tiles are t0 x t1 blocks over (ord[0], ord[1]), the other dims are walked one by one,
+//    so transposed operands are read within a cache sized block
+template<u32 N>
+struct EvalPlan
+{
+    u32         _ord[N];
+    vec<u32,N>  _dims;
+    u32         _t0, _t1;   // tile extent
+    u32         _k0, _k1;   // tiles along ord[0], ord[1]
+    u64         _tiles;
+
+    template<class T>
+    static fn from_slice(const NDSlice<T,N>& dst, const EvalOpts& opts) noexcept -> EvalPlan {
+        mut res   = EvalPlan{};
+        res._dims = dst._dims;
+
+        // insertion sort by |stride|, dims of size 1 go last
+        for (mut i = 0u; i < N; ++i) {
+            res._ord[i] = i;
+        }
+        let key = [&](u32 d) -> u64 {
+            return dst._dims[d] <= 1 ? ~u64(0) : u64(ustd::abs(dst._step[d]));
+        };
+        for (mut i = 1u; i < N; ++i) {
+            for (mut j = i; j > 0 && key(res._ord[j]) < key(res._ord[j - 1]); --j) {
+                ustd::swap(res._ord[j], res._ord[j - 1]);
             }
         }
+
+        let n0 = res._dims[res._ord[0]];
+        let n1 = N > 1 ? res._dims[res._ord[N > 1 ? 1 : 0]] : 1u;
+
+        let elems = ustd::max(opts._tile_bytes / u32(sizeof(T)), 1u);
+        res._t0   = N > 1 ? ustd::max(ustd::min(n0, opts._tile_inner), 1u) : ustd::max(ustd::min(n0, elems), 1u);
+        res._t1   = ustd::max(ustd::min(n1, elems / res._t0), 1u);
+        res._k0   = (n0 + res._t0 - 1) / res._t0;
+        res._k1   = (n1 + res._t1 - 1) / res._t1;
+
+        res._tiles = u64(res._k0) * res._k1;
+        for (mut i = 2u; i < N; ++i) {
+            res._tiles *= res._dims[res._ord[i]];
+        }
+        return res;
+    }
+
+    // tile id -> start index and extents, ord[0] tiles vary fastest
+    fn tile(u64 id, vec<u32,N>& idx, u32& e0, u32& e1) const noexcept -> void {
+        let b0 = u32(id % _k0); id /= _k0;
+        let b1 = u32(id % _k1); id /= _k1;
+
+        idx = vec<u32,N>{};
+        idx[_ord[0]] = b0 * _t0;
+        e0 = ustd::min(idx[_ord[0]] + _t0, _dims[_ord[0]]);
+
+        if constexpr (N > 1) {
+            idx[_ord[1]] = b1 * _t1;
+            e1 = ustd::min(idx[_ord[1]] + _t1, _dims[_ord[1]]);
+        }
+        else {
+            e1 = 1;
+        }
+
+        for (mut i = 2u; i < N; ++i) {
+            let n = _dims[_ord[i]];
+            idx[_ord[i]] = u32(id % n);
+            id /= n;
+        }
+    }
+};
+
+template<class O, class T, u32 N, class F>
+fn eval_tile(NDSlice<T,N>& dst, const F& src, const EvalPlan<N>& plan, u64 id) noexcept -> void {
+    mut idx = vec<u32,N>{};
+    mut e0  = 0u;
+    mut e1  = 0u;
+    plan.tile(id, idx, e0, e1);
+
+    let d0 = plan._ord[0];
+    let x0 = idx[d0];
+
+    if constexpr (N == 1) {
+        eval_row<O>(dst, src, idx, d0, x0, e0);
+    }
+    else {
+        let d1 = plan._ord[1];
+        for (mut y = idx[d1]; y < e1; ++y) {
+            idx[d1] = y;
+            eval_row<O>(dst, src, idx, d0, x0, e0);
+        }
     }
 }
 
-template<class O, class T, class F>
-fn foreach(NDSlice<T,4>& dst, const F& src) -> void {
-    let dims = dst.dims();
-    
-    for(mut x = 0u; x < dims.x; ++x) {
-        for(mut y = 0u; y < dims.y; ++y) {
-            for(mut z = 0u; z < dims.z; ++z) {
-                for(mut w = 0u; w < dims.w; ++w) {
-                    dst(x, y, z, w) = src(x, y, z, w);
-                }
-            }
+// foreach: dst @= src, tiled, in stride order, on the shared pool above `_par_min` elements
+template<class O, class T, u32 N, class F>
+fn foreach(NDSlice<T,N>& dst, const F& src) -> void {
+    let cnt = u64(dst.count());
+    if (cnt == 0) {
+        return;
+    }
+
+    let& opts = eval_opts();
+    let  plan = EvalPlan<N>::from_slice(dst, opts);
+
+    if (cnt < opts._par_min || plan._tiles == 1) {
+        for (mut id = u64(0); id < plan._tiles; ++id) {
+            eval_tile<O>(dst, src, plan, id);
         }
+        return;
     }
+
+    thread::parallel_for(thread::Range{ 0, plan._tiles }, 1, [&](thread::Range sub) {
+        for (mut id = sub._start; id < sub._end; ++id) {
+            eval_tile<O>(dst, src, plan, id);
+        }
+    });
 }
+#pragma endregion
 
 template<class T, u32 N, class U>
 fn operator<<=(NDSlice<T, N>& dst, const U& src) noexcept -> NDSlice<T, N>& {
@@ -258,7 +421,7 @@ fn operator-=(NDSlice<T, N>& dst, const U& src) noexcept -> NDSlice<T, N>& {
 
 template<class T, u32 N, class U>
 fn operator*=(NDSlice<T, N>& dst, const U& src) noexcept -> NDSlice<T, N>& {
-    foreach<ops::MulTo>(dst, _to_ndslice(src));
+    foreach<ops::MulTo>(dst, to_ndvec(src));
     return dst;
 }
 
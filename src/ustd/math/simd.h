@@ -0,0 +1,134 @@
+#pragma once
+
+#include "ustd/core/builtin.h"
+#include "ustd/core/ops.h"
+
+// USTD_SIMD_BYTES: packet width, select with the target flags or define it explicitly
+//  - 64: AVX-512 (-mavx512f)
+//  - 32: AVX/AVX2 (-mavx2)
+//  - 16: SSE2/NEON
+//  -  0: scalar, one element per packet
+#ifndef USTD_SIMD_BYTES
+#   if defined(__AVX512F__)
+#       define USTD_SIMD_BYTES 64
+#   elif defined(__AVX__)
+#       define USTD_SIMD_BYTES 32
+#   elif defined(__SSE2__) || defined(__ARM_NEON)
+#       define USTD_SIMD_BYTES 16
+#   else
+#       define USTD_SIMD_BYTES 0
+#   endif
+#endif
+
+namespace ustd::math
+{
+
+// packet: $size lanes of T, lowered to SSE/AVX/AVX-512 registers by the compiler
+template<class T>
+struct packet_t
+{
+    constexpr static let $bytes = u32(USTD_SIMD_BYTES) > u32(sizeof(T)) ? u32(USTD_SIMD_BYTES) : u32(sizeof(T));
+    constexpr static let $size  = u32($bytes / sizeof(T));
+
+    using val_t = T;
+    using raw_t = T __attribute__((vector_size($bytes)));
+
+    raw_t _raw;
+
+#pragma region ctor
+    // ctor: load, unaligned
+    static fn load(const T* ptr) noexcept -> packet_t {
+        mut res = packet_t{};
+        __builtin_memcpy(&res._raw, ptr, sizeof(raw_t));
+        return res;
+    }
+
+    // ctor: load, `ptr` aligned to $bytes
+    static fn load_aligned(const T* ptr) noexcept -> packet_t {
+        return { *static_cast<const raw_t*>(__builtin_assume_aligned(ptr, $bytes)) };
+    }
+
+    // ctor: splat
+    static fn splat(T val) noexcept -> packet_t {
+        return { raw_t{} + val };
+    }
+
+    // ctor: iota, {0, 1, 2, ...}
+    static fn iota() noexcept -> packet_t {
+        mut res = packet_t{};
+        for (mut i = 0u; i < $size; ++i) {
+            res._raw[i] = T(i);
+        }
+        return res;
+    }
+#pragma endregion
+
+#pragma region method
+    // method: store, unaligned
+    fn store(T* ptr) const noexcept -> void {
+        __builtin_memcpy(ptr, &_raw, sizeof(raw_t));
+    }
+
+    // method: store, `ptr` aligned to $bytes
+    fn store_aligned(T* ptr) const noexcept -> void {
+        *static_cast<raw_t*>(__builtin_assume_aligned(ptr, $bytes)) = _raw;
+    }
+
+    fn operator[](u32 idx) const noexcept -> T {
+        return _raw[idx];
+    }
+#pragma endregion
+
+#pragma region operator
+    fn operator+() const noexcept -> packet_t { return { +_raw }; }
+    fn operator-() const noexcept -> packet_t { return { -_raw }; }
+
+    fn operator+(const packet_t& b) const noexcept -> packet_t { return { _raw + b._raw }; }
+    fn operator-(const packet_t& b) const noexcept -> packet_t { return { _raw - b._raw }; }
+    fn operator*(const packet_t& b) const noexcept -> packet_t { return { _raw * b._raw }; }
+    fn operator/(const packet_t& b) const noexcept -> packet_t { return { _raw / b._raw }; }
+
+    fn operator+=(const packet_t& b) noexcept -> packet_t& { _raw += b._raw; return *this; }
+    fn operator-=(const packet_t& b) noexcept -> packet_t& { _raw -= b._raw; return *this; }
+    fn operator*=(const packet_t& b) noexcept -> packet_t& { _raw *= b._raw; return *this; }
+    fn operator/=(const packet_t& b) noexcept -> packet_t& { _raw /= b._raw; return *this; }
+
+    // this += a * b, one expression so the compiler may contract it to fma
+    fn mul_add(const packet_t& a, const packet_t& b) noexcept -> packet_t& {
+        _raw += a._raw * b._raw;
+        return *this;
+    }
+
+    // method: sum of all lanes
+    fn hsum() const noexcept -> T {
+        mut res = T(0);
+        for (mut i = 0u; i < $size; ++i) {
+            res += _raw[i];
+        }
+        return res;
+    }
+#pragma endregion
+};
+
+#pragma region $packet_op
+// ops that have a lane-wise packet form
+template<class F> struct _packet_op             { constexpr static let $value = false; };
+template<>        struct _packet_op<ops::Pos>   { constexpr static let $value = true;  };
+template<>        struct _packet_op<ops::Neg>   { constexpr static let $value = true;  };
+template<>        struct _packet_op<ops::Add>   { constexpr static let $value = true;  };
+template<>        struct _packet_op<ops::Sub>   { constexpr static let $value = true;  };
+template<>        struct _packet_op<ops::Mul>   { constexpr static let $value = true;  };
+template<>        struct _packet_op<ops::Div>   { constexpr static let $value = true;  };
+template<>        struct _packet_op<ops::Pow2>  { constexpr static let $value = true;  };
+template<>        struct _packet_op<ops::Pow3>  { constexpr static let $value = true;  };
+template<>        struct _packet_op<ops::SetTo> { constexpr static let $value = true;  };
+template<>        struct _packet_op<ops::AddTo> { constexpr static let $value = true;  };
+template<>        struct _packet_op<ops::SubTo> { constexpr static let $value = true;  };
+template<>        struct _packet_op<ops::MulTo> { constexpr static let $value = true;  };
+template<>        struct _packet_op<ops::DivTo> { constexpr static let $value = true;  };
+
+template<class F>
+constexpr static let $packet_op = _packet_op<F>::$value;
+#pragma endregion
+
+}
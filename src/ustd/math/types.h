@@ -2,6 +2,7 @@
 
 #include "ustd/core/builtin.h"
 #include "ustd/core/vec.h"
+#include "ustd/math/simd.h"
 
 namespace ustd
 {
@@ -30,6 +31,15 @@ struct ndvec_t: public _ndvec_t
 {
     using val_t = T;
     constexpr static let $rank = N;
+
+    // packet: nodes that can be evaluated as packet_t<V> along dim 0
+    template<class V>
+    constexpr static let $packet = false;
+
+    // property[r]: dim 0 is dense, packets may be loaded
+    fn is_packed() const noexcept -> bool {
+        return false;
+    }
 };
 
 template<typename T>
@@ -58,6 +68,18 @@ struct scalar_t: ndvec_t<T, 0>
     fn operator()(const U& ...u) noexcept -> T& {
         return _val;
     }
+
+    template<class V>
+    constexpr static let $packet = trait<T>::$num && trait<V>::$num;
+
+    fn is_packed() const noexcept -> bool {
+        return true;
+    }
+
+    template<class P, class ...U>
+    fn load_packet(const U& ...u) const noexcept -> P {
+        return P::splat(typename P::val_t(_val));
+    }
 };
 
 template<class T, class F>
@@ -25,6 +25,22 @@ struct vline_t: ndvec_t<T,N>
         return at(seq_t<N>{}, idxs...);
     }
 
+    template<class V>
+    constexpr static let $packet = trait<T>::$num && trait<V>::$num;
+
+    fn is_packed() const noexcept -> bool {
+        return true;
+    }
+
+    // packet: at(x, ...) + {0, 1, 2, ...} * step[0]
+    template<class P, typename ...I, class=when<sizeof...(I)==N> >
+    fn load_packet(I ...idxs) const noexcept -> P {
+        using V = typename P::val_t;
+        let base = P::splat(V(at(seq_t<N>{}, idxs...)));
+        let step = P::splat(V(_step[0]));
+        return base + P::iota() * step;
+    }
+
     template<u32 ...K, typename ...I>
     fn at(immut_t<u32, K...>, I ...idxs) const -> T {
         return ustd::sum((T(_step[K])*idxs)...);
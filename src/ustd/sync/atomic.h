@@ -5,6 +5,40 @@
 namespace ustd::sync
 {
 
+enum class Ordering : i32
+{
+    Relaxed = __ATOMIC_RELAXED,
+    Acquire = __ATOMIC_ACQUIRE,
+    Release = __ATOMIC_RELEASE,
+    AcqRel  = __ATOMIC_ACQ_REL,
+    SeqCst  = __ATOMIC_SEQ_CST,
+};
+
+template<class T>
+fn load(const T* ptr, Ordering order = Ordering::SeqCst) noexcept -> T {
+    return __atomic_load_n(ptr, i32(order));
+}
+
+template<class T>
+fn store(T* ptr, T value, Ordering order = Ordering::SeqCst) noexcept -> void {
+    __atomic_store_n(ptr, value, i32(order));
+}
+
+template<class T>
+fn exchange(T* ptr, T value, Ordering order = Ordering::SeqCst) noexcept -> T {
+    return __atomic_exchange_n(ptr, value, i32(order));
+}
+
+// { if (*ptr == expect) { *ptr = value; return true; } return false; }
+template<class T>
+fn compare_exchange(T* ptr, T expect, T value, Ordering order = Ordering::SeqCst) noexcept -> bool {
+    return __atomic_compare_exchange_n(ptr, &expect, value, false, i32(order), __ATOMIC_RELAXED);
+}
+
+inline fn fence(Ordering order = Ordering::SeqCst) noexcept -> void {
+    __atomic_thread_fence(i32(order));
+}
+
 template<class T>
 fn fetch_and_add(T* target, T value) noexcept -> T {
     return __sync_fetch_and_add(target, value);
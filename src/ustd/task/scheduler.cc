@@ -3,72 +3,69 @@
 namespace ustd::task
 {
 
+using status_t = ITask::status_t;
+
 pub Scheduler::Scheduler()
+    : Scheduler(thread::Pool::global())
+{}
+
+pub Scheduler::Scheduler(thread::Pool& pool)
+    : _pool(&pool)
+    , _mtx()
+    , _cnd()
+    , _tasks()
+    , _remaining(0)
+    , _failed(0)
 {}
 
 pub Scheduler::~Scheduler()
 {}
 
 pub Scheduler::Scheduler(Scheduler&& other) noexcept
-    : _mtx(as_mov(other._mtx))
+    : _pool(other._pool)
+    , _mtx(as_mov(other._mtx))
     , _cnd(as_mov(other._cnd))
     , _tasks(as_mov(other._tasks))
+    , _remaining(other._remaining)
+    , _failed(other._failed)
 {}
 
 pub fn Scheduler::add(ITask& task) noexcept -> void {
     mut lock = _mtx.lock();
+    task._owner = this;
     _tasks.push(&task);
-    _cnd.notify_all();
 }
 
-pub fn Scheduler::run() noexcept -> void {
-
-    while (true) {
-        // get task
-        let task_opt = [&]() -> Option<ITask&> {
-            mut lock = _mtx.lock().unwrap();
-
-            while (!_tasks.is_empty()) {
-                for (mut& ptask : _tasks.into_iter()) {
-                    if (ptask->is_ready()) {
-                        // swap
-                        mut& plast = _tasks[_tasks._size - 1];
-                        ustd::swap(ptask, plast);
-                        _tasks.pop();
-
-                        // sleep 10ms
-                        thread::sleep_ms(10);
-                        return Option<ITask&>::Some(*plast);
-                    }
-                }
-
-                let timeout_ms = 1000;
-                _cnd.wait_timeout_ms(lock, timeout_ms);
-            };
-
-            return Option<ITask&>::None();
+pub fn Scheduler::run() noexcept -> bool {
+    if (!prepare()) {
+        return false;
+    }
 
-        }();
+    sync::store(&_remaining, u32(_tasks._size));
+    sync::store(&_failed, 0u);
 
-        // check
-        if (task_opt.is_none()) {
-            break;
+    for (mut ptask : _tasks.into_iter()) {
+        if (ptask->_pending == 0) {
+            spawn(ptask);
         }
-        mut& task = task_opt._val;
-
-        // run
-        let ret = task.schedule();
+    }
 
-        // notify
-        mut lock = _mtx.lock();
-        _cnd.notify_all();
+    // help the pool until the graph drains
+    while (sync::load(&_remaining, sync::Ordering::Acquire) != 0) {
+        if (_pool->try_run_one()) {
+            continue;
+        }
 
-        if (!ret) {
+        mut lock = _mtx.lock().unwrap();
+        if (sync::load(&_remaining, sync::Ordering::Acquire) == 0) {
             break;
         }
+        _cnd.wait_timeout_ms(lock, 1);
     }
 
-    return;
+    // the last task notifies under `_mtx`, wait until it let go of `this`
+    mut lock = _mtx.lock();
+    return sync::load(&_failed) == 0;
 }
 
 pub fn Scheduler::async_run(str thr_name) noexcept -> thread::JoinHandle<void> {
@@ -80,6 +77,107 @@ pub fn Scheduler::async_run(str thr_name) noexcept -> thread::JoinHandle<void> {
     return as_mov(thr_join);
 }
 
+fn Scheduler::prepare() noexcept -> bool {
+    mut lock = _mtx.lock();
+
+    for (mut ptask : _tasks.into_iter()) {
+        ptask->_status  = status_t::None;
+        ptask->_pending = 0;
+    }
+
+    // count predecessors in this graph, outside ones must be done already
+    for (mut ptask : _tasks.into_iter()) {
+        for (mut pdep : ptask->_depends.into_iter()) {
+            if (pdep->_owner == this) {
+                ptask->_pending += 1;
+                continue;
+            }
+            if (pdep->_status != status_t::Success) {
+                log::error("ustd::task::Scheduler[{}].run() -> Error(`task[{}] depends on task[{}] from another graph`)", this, ptask, pdep);
+                return false;
+            }
+        }
+    }
+
+    // Kahn's walk: a task never reached lies on a cycle
+    mut order = List<ITask*>::with_capacity(_tasks._size);
+    for (mut ptask : _tasks.into_iter()) {
+        if (ptask->_pending == 0) {
+            order.push(ptask);
+        }
+    }
+
+    for (mut i = 0u; i < order._size; ++i) {
+        for (mut psucc : order[i]->_successors.into_iter()) {
+            if (psucc->_owner != this) continue;
+            if (--psucc->_pending == 0) {
+                order.push(psucc);
+            }
+        }
+    }
+
+    if (order._size != _tasks._size) {
+        log::error("ustd::task::Scheduler[{}].run() -> Error(`dependency cycle among {} tasks`)", this, _tasks._size - order._size);
+        return false;
+    }
+
+    // the walk consumed the counters, count again
+    for (mut ptask : _tasks.into_iter()) {
+        for (mut pdep : ptask->_depends.into_iter()) {
+            if (pdep->_owner == this) {
+                ptask->_pending += 1;
+            }
+        }
+    }
+    return true;
+}
+
+fn Scheduler::spawn(ITask* task) noexcept -> void {
+    _pool->push([this, task]() {
+        this->exec(task);
+    });
+}
+
+fn Scheduler::exec(ITask* task) noexcept -> void {
+    mut next = task;
+
+    while (next != nullptr) {
+        let cur = next;
+        next = nullptr;
+
+        // predecessors are finished here, a failed one fails this task too
+        mut ret = false;
+        if (cur->is_ready()) {
+            ret = cur->schedule();
+        }
+        else {
+            cur->_status = status_t::Failed;
+        }
+
+        if (!ret) {
+            sync::fetch_and_add(&_failed, 1u);
+        }
+
+        for (mut psucc : cur->_successors.into_iter()) {
+            if (psucc->_owner != this) continue;
+            if (sync::fetch_and_sub(&psucc->_pending, 1u) != 1) continue;
+
+            // keep one ready successor on this thread, hand the rest to the pool
+            if (next == nullptr) {
+                next = psucc;
+            }
+            else {
+                spawn(psucc);
+            }
+        }
+
+        if (sync::fetch_and_sub(&_remaining, 1u) == 1) {
+            mut lock = _mtx.lock();
+            _cnd.notify_all();
+        }
+    }
+}
+
 unittest(task) {
     class Task : public ITask {
     public:
@@ -112,7 +210,50 @@ unittest(task) {
     scheduler.add(tasks[2]);
     scheduler.add(tasks[3]);
 
-    scheduler.async_run("ustd::task::scheduler::test");
+    mut thr = scheduler.async_run("ustd::task::scheduler::test");
+    thr.join();
+
+    for (mut& task : tasks) {
+        assert_eq(task._status == ITask::status_t::Success, true);
+    }
+}
+
+unittest(task_pipeline) {
+    class Stage : public ITask {
+    public:
+        u32  _idx;
+        u32* _cnt;
+
+        Stage(u32 idx, u32* cnt) : _idx(idx), _cnt(cnt)
+        {}
+
+        fn exec() -> void override {
+            let k = sync::fetch_and_add(_cnt, 1u);
+            test::assert_eq(k, _idx);
+        }
+    };
+
+    let n   = 10000u;
+    mut cnt = 0u;
+
+    mut stages = List<Stage>::with_capacity(n);
+    for (mut i = 0u; i < n; ++i) {
+        stages.push(i, &cnt);
+    }
+
+    mut scheduler = Scheduler();
+    for (mut i = 0u; i < n; ++i) {
+        if (i != 0) stages[i].add_depend(stages[i - 1]);
+        scheduler.add(stages[i]);
+    }
+
+    let t0 = time::Instant::now();
+    let ok = scheduler.run();
+    let t1 = time::Instant::now();
+
+    assert_eq(ok, true);
+    assert_eq(cnt, n);
+    log::info("ustd::task::Scheduler: {} stages in {}", n, t1 - t0);
 }
 
 }
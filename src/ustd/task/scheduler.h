@@ -7,24 +7,42 @@
 namespace ustd::task
 {
 
+// dependency-counting DAG executor
+//  - every task counts its unfinished predecessors
+//  - a finished task pushes the successors it made ready onto the pool
+//  - successors of a failed task are marked `Failed` without running
 class Scheduler final
 {
 public:
-    constexpr static let $capacity = 64;
-    using tasks_t = FixedList<ITask*, $capacity>;
+    using tasks_t = List<ITask*>;
 
+    thread::Pool*   _pool;
     sync::Mutex     _mtx;
     sync::CondVar   _cnd;
     tasks_t         _tasks;
+    u32             _remaining;     // atomic, tasks not finished in current run
+    u32             _failed;        // atomic, tasks failed in current run
 
+    // ctor: run on `thread::Pool::global()`
     pub Scheduler();
+
+    // ctor: run on `pool`
+    pub explicit Scheduler(thread::Pool& pool);
+
     pub ~Scheduler();
     pub Scheduler(Scheduler&& other) noexcept;
 
+    // method: add a task, all its predecessors must be added before `run`
     pub fn add(ITask& task) noexcept -> void;
 
-    pub fn run()                    noexcept -> void;
+    // method: run the graph until every task finished, false if any failed
+    pub fn run()                    noexcept -> bool;
     pub fn async_run(str thr_name)  noexcept->thread::JoinHandle<void>;
+
+private:
+    fn prepare()                    noexcept -> bool;
+    fn spawn(ITask* task)           noexcept -> void;
+    fn exec(ITask* task)            noexcept -> void;
 };
 
-}
\ No newline at end of file
+}
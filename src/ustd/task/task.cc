@@ -5,6 +5,10 @@ namespace ustd::task
 
 pub ITask::ITask() noexcept
     : _status(status_t::None)
+    , _depends()
+    , _successors()
+    , _pending(0)
+    , _owner(nullptr)
 {}
 
 pub ITask::~ITask() noexcept
@@ -30,6 +34,7 @@ pub fn ITask::is_ready() noexcept -> bool {
 
 pub fn ITask::add_depend(ITask& task) noexcept -> void {
     _depends.push(&task);
+    task._successors.push(this);
 }
 
 pub fn ITask::schedule() noexcept -> bool {
@@ -16,11 +16,13 @@ public:
         Failed,
     };
 
-    constexpr static let $capacity = 8u;
-    using depends_t = FixedList<ITask*, $capacity>;
+    using depends_t = List<ITask*>;
 
     volatile status_t   _status;
-    depends_t           _depends;
+    depends_t           _depends;       // predecessors
+    depends_t           _successors;    // tasks that depend on this one
+    u32                 _pending;       // atomic, unfinished predecessors
+    Scheduler*          _owner;
 
     pub virtual ~ITask() noexcept;
 
@@ -38,4 +40,3 @@ protected:
 };
 
 }
-
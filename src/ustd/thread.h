@@ -1,6 +1,8 @@
 #pragma once
 
+#include "ustd/thread/deque.h"
 #include "ustd/thread/funcs.h"
+#include "ustd/thread/parallel.h"
 #include "ustd/thread/pool.h"
 #include "ustd/thread/thread.h"
 
@@ -0,0 +1,183 @@
+#pragma once
+
+#include "ustd/core.h"
+#include "ustd/sync/atomic.h"
+
+namespace ustd::thread
+{
+
+// Chase-Lev work-stealing deque.
+//  - owner: push/pop at bottom (LIFO)
+//  - thief: steal at top       (FIFO)
+// T must be trivially copyable and fit into a machine word.
+// @see: "Correct and Efficient Work-Stealing for Weak Memory Models" (PPoPP'13)
+template<class T>
+class WorkDeque
+{
+public:
+    using Ordering = sync::Ordering;
+
+    // | ....xxxxxxxx.... |
+    // |     ^       ^    |
+    // |    top   bottom  |
+    struct Ring
+    {
+        i64     _mask;
+        Ring*   _prev;          // retired rings, released by dtor
+        T*      _data;
+
+        fn capacity() const noexcept -> i64 {
+            return _mask + 1;
+        }
+
+        fn get(i64 idx) const noexcept -> T {
+            return sync::load(&_data[idx & _mask], Ordering::Relaxed);
+        }
+
+        fn set(i64 idx, T val) noexcept -> void {
+            sync::store(&_data[idx & _mask], val, Ordering::Relaxed);
+        }
+    };
+
+    // owner and thieves touch different cache lines
+    i64     _top;
+    u8      _pad0[56];
+    i64     _bottom;
+    u8      _pad1[56];
+    Ring*   _ring;
+
+#pragma region ctor/dtor
+    WorkDeque(WorkDeque&& other) noexcept
+        : _top(other._top), _pad0(), _bottom(other._bottom), _pad1(), _ring(other._ring)
+    {
+        other._ring = nullptr;
+    }
+
+    ~WorkDeque() noexcept {
+        mut ring = _ring;
+        while (ring != nullptr) {
+            let prev = ring->_prev;
+            del_ring(ring);
+            ring = prev;
+        }
+    }
+
+    // ctor: with_capacity, round up to power of 2
+    static fn with_capacity(u32 capacity) noexcept -> WorkDeque {
+        mut cap = i64(16);
+        while (cap < i64(capacity)) {
+            cap *= 2;
+        }
+        return WorkDeque(new_ring(cap, nullptr));
+    }
+#pragma endregion
+
+#pragma region property
+    // property[r]: len, approximate when accessed by thieves
+    fn len() const noexcept -> u64 {
+        let b = sync::load(&_bottom, Ordering::Relaxed);
+        let t = sync::load(&_top,    Ordering::Relaxed);
+        return b > t ? u64(b - t) : 0u;
+    }
+
+    fn is_empty() const noexcept -> bool {
+        return len() == 0;
+    }
+#pragma endregion
+
+#pragma region owner
+    // method: push, owner only
+    fn push(T val) noexcept -> void {
+        let b = sync::load(&_bottom, Ordering::Relaxed);
+        let t = sync::load(&_top,    Ordering::Acquire);
+        mut r = sync::load(&_ring,   Ordering::Relaxed);
+
+        if (b - t > r->_mask) {
+            r = grow(r, t, b);
+        }
+
+        r->set(b, val);
+        sync::fence(Ordering::Release);
+        sync::store(&_bottom, b + 1, Ordering::Relaxed);
+    }
+
+    // method: pop, owner only
+    fn pop() noexcept -> Option<T> {
+        let b = sync::load(&_bottom, Ordering::Relaxed) - 1;
+        let r = sync::load(&_ring,   Ordering::Relaxed);
+        sync::store(&_bottom, b, Ordering::Relaxed);
+        sync::fence(Ordering::SeqCst);
+        let t = sync::load(&_top, Ordering::Relaxed);
+
+        // empty
+        if (t > b) {
+            sync::store(&_bottom, b + 1, Ordering::Relaxed);
+            return Option<T>::None();
+        }
+
+        let val = r->get(b);
+        if (t != b) {
+            return Option<T>::Some(val);
+        }
+
+        // last element: race with thieves
+        let won = sync::compare_exchange(&_top, t, t + 1, Ordering::SeqCst);
+        sync::store(&_bottom, b + 1, Ordering::Relaxed);
+
+        if (!won) {
+            return Option<T>::None();
+        }
+        return Option<T>::Some(val);
+    }
+#pragma endregion
+
+#pragma region thief
+    // method: steal, any thread
+    fn steal() noexcept -> Option<T> {
+        let t = sync::load(&_top, Ordering::Acquire);
+        sync::fence(Ordering::SeqCst);
+        let b = sync::load(&_bottom, Ordering::Acquire);
+
+        if (t >= b) {
+            return Option<T>::None();
+        }
+
+        let r   = sync::load(&_ring, Ordering::Acquire);
+        let val = r->get(t);
+        if (!sync::compare_exchange(&_top, t, t + 1, Ordering::SeqCst)) {
+            return Option<T>::None();   // lost the race, caller may retry
+        }
+        return Option<T>::Some(val);
+    }
+#pragma endregion
+
+private:
+    explicit WorkDeque(Ring* ring) noexcept
+        : _top(0), _pad0(), _bottom(0), _pad1(), _ring(ring)
+    {}
+
+    static fn new_ring(i64 capacity, Ring* prev) noexcept -> Ring* {
+        mut res = mnew<Ring>(1);
+        res->_mask = capacity - 1;
+        res->_prev = prev;
+        res->_data = mnew<T>(u64(capacity));
+        return res;
+    }
+
+    static fn del_ring(Ring* ring) noexcept -> void {
+        mdel(ring->_data);
+        mdel(ring);
+    }
+
+    // thieves may still read the old ring, so it is retired instead of released
+    fn grow(Ring* old_ring, i64 t, i64 b) noexcept -> Ring* {
+        mut ring = new_ring(old_ring->capacity() * 2, old_ring);
+        for (mut i = t; i < b; ++i) {
+            ring->set(i, old_ring->get(i));
+        }
+        sync::store(&_ring, ring, Ordering::Release);
+        return ring;
+    }
+};
+
+}
@@ -5,6 +5,7 @@ using namespace ustd;
 using namespace ustd::thread;
 
 extern "C" fn SleepEx(u32 milli_seconds, i32 alert_able) -> u32 ;
+extern "C" fn GetActiveProcessorCount(u16 group_number) -> u32;
 
 static fn nanosleep(const timespec* req, timespec* rem) noexcept -> i32 {
     let t0 = time::Instant::now();
@@ -58,4 +59,13 @@ pub fn sleep_to(time::Instant time_to)  noexcept->time::Duration {
     return time_res;
 }
 
+pub fn available_parallelism() noexcept -> u32 {
+#ifdef _WIN32
+    let cnt = i64(::GetActiveProcessorCount(0xFFFF));   // ALL_PROCESSOR_GROUPS
+#else
+    let cnt = i64(::sysconf(_SC_NPROCESSORS_ONLN));
+#endif
+    return cnt > 0 ? u32(cnt) : 1u;
+}
+
 }
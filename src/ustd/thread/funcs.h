@@ -9,4 +9,7 @@ pub fn sleep    (time::Duration dur) noexcept -> time::Duration;
 pub fn sleep_ms (u32 ms)             noexcept -> u32;
 pub fn sleep_to(time::Instant time)  noexcept -> time::Duration;
 
+// number of cpus the process may run on, at least 1
+pub fn available_parallelism() noexcept -> u32;
+
 }
@@ -0,0 +1,119 @@
+#include "config.inl"
+
+namespace ustd::thread
+{
+
+// bounds the chunk count, and so the partials of `parallel_reduce`
+static constexpr let $max_chunks = u64(1) << 20;
+
+pub fn Group::wait() noexcept -> void {
+    while (sync::load(&_pending, sync::Ordering::Acquire) != 0) {
+        if (_pool->try_run_one()) {
+            continue;
+        }
+        thread::yield();
+    }
+}
+
+pub fn Chunks::with_partition(Range range, u64 grain, Partition part, u32 workers) noexcept -> Chunks {
+    let len = range.len();
+    mut res = Chunks{ range, len, 1u, List<u64>() };
+
+    switch (part) {
+    case Partition::Static: {
+        let max_cnt = (len + grain - 1) / grain;
+        let cnt     = ustd::min(u64(workers), max_cnt);
+        res._step   = (len + cnt - 1) / cnt;
+        res._cnt    = u32((len + res._step - 1) / res._step);
+        break;
+    }
+    case Partition::Dynamic: {
+        let min_step = (len + $max_chunks - 1) / $max_chunks;
+        res._step    = ustd::max(grain, min_step);
+        res._cnt     = u32((len + res._step - 1) / res._step);
+        break;
+    }
+    case Partition::Guided: {
+        // chunk = remaining / (2 * workers), never below grain
+        let div = u64(workers) * 2;
+        res._bounds.push(range._start);
+
+        mut pos = range._start;
+        while (pos < range._end) {
+            let rem  = range._end - pos;
+            let step = ustd::min(rem, ustd::max(grain, rem / div));
+            pos += step;
+            res._bounds.push(pos);
+        }
+        res._cnt = res._bounds._size - 1;
+        break;
+    }
+    }
+
+    return res;
+}
+
+unittest(parallel_for) {
+    let n   = 1000000u;
+    mut buf = List<u32>::with_capacity(n);
+    buf.pushn(n, 0u);
+
+    Partition parts[] = { Partition::Static, Partition::Dynamic, Partition::Guided };
+    for (let part : parts) {
+        thread::parallel_for(Range{ 0, n }, 1024, [&](Range sub) {
+            for (mut i = sub._start; i < sub._end; ++i) {
+                buf[u32(i)] += 1;
+            }
+        }, part);
+    }
+
+    for (mut i = 0u; i < n; ++i) {
+        assert_eq(buf[i], 3u);
+    }
+}
+
+unittest(parallel_reduce) {
+    let n = u64(10000000);
+
+    Partition parts[] = { Partition::Static, Partition::Dynamic, Partition::Guided };
+    for (let part : parts) {
+        let t0  = time::Instant::now();
+        let sum = thread::parallel_reduce(Range{ 0, n }, 4096, u64(0),
+            [](Range sub, u64 acc) {
+                for (mut i = sub._start; i < sub._end; ++i) {
+                    acc += i;
+                }
+                return acc;
+            },
+            [](u64 a, u64 b) { return a + b; },
+            part);
+        let t1  = time::Instant::now();
+
+        assert_eq(sum, n * (n - 1) / 2);
+        log::info("ustd::thread::parallel_reduce[{}]: {}", u32(part), t1 - t0);
+    }
+
+    // init is folded in once, not once per chunk
+    let base = thread::parallel_reduce(Range{ 0, 100000 }, 16, u64(1000),
+        [](Range sub, u64 acc) { return acc + sub.len(); },
+        [](u64 a, u64 b) { return a + b; });
+    assert_eq(base, u64(101000));
+
+    // join is applied in range order
+    struct Span { u64 _first; u64 _last; bool _ok; };
+
+    let span = thread::parallel_reduce(Range{ 0, 100000 }, 16, Span{ 0, 0, false },
+        [](Range sub, Span acc) {
+            (void)acc;
+            return Span{ sub._start, sub._end - 1, true };
+        },
+        [](Span a, Span b) {
+            return Span{ a._first, b._last, a._ok && b._ok && a._last + 1 == b._first };
+        },
+        Partition::Guided);
+    assert_eq(span._ok, true);
+    assert_eq(span._first, u64(0));
+    assert_eq(span._last,  u64(99999));
+}
+
+}
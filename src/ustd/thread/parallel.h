@@ -0,0 +1,211 @@
+#pragma once
+
+#include "ustd/core.h"
+#include "ustd/sync/atomic.h"
+#include "ustd/thread/pool.h"
+
+namespace ustd::thread
+{
+
+// half-open index range: [_start, _end)
+struct Range
+{
+    u64 _start;
+    u64 _end;
+
+    fn len() const noexcept -> u64 {
+        return _end > _start ? _end - _start : 0u;
+    }
+
+    fn is_empty() const noexcept -> bool {
+        return _end <= _start;
+    }
+};
+
+enum class Partition
+{
+    Static,     // one equal chunk per worker
+    Dynamic,    // `grain` sized chunks, recursively split and stolen
+    Guided,     // decreasing chunks, claimed first come first served
+};
+
+// a set of jobs on a pool, `wait` helps running jobs until the set drains
+class Group
+{
+public:
+    Pool*   _pool;
+    u32     _pending;   // atomic
+
+    explicit Group(Pool& pool) noexcept
+        : _pool(&pool), _pending(0)
+    {}
+
+    Group(Group&&) = delete;
+
+    ~Group() noexcept {
+        wait();
+    }
+
+    template<class F>
+    fn spawn(F&& f) noexcept -> void {
+        sync::fetch_and_add(&_pending, 1u);
+        _pool->push([this, f = as_fwd<F>(f)]() mutable {
+            // the count drops even when `f` unwinds, or `wait` never returns
+            struct Done {
+                u32* _pending;
+                ~Done() noexcept { sync::fetch_and_sub(_pending, 1u); }    // last touch of `this`
+            };
+            let done = Done{ &_pending };
+            f();
+        });
+    }
+
+    pub fn wait() noexcept -> void;
+};
+
+// chunk boundaries of a parallel loop
+class Chunks
+{
+public:
+    Range       _range;
+    u64         _step;      // Static/Dynamic: chunk size
+    u32         _cnt;
+    List<u64>   _bounds;    // Guided: _cnt + 1 boundaries
+
+    pub static fn with_partition(Range range, u64 grain, Partition part, u32 workers) noexcept -> Chunks;
+
+    fn operator[](u32 idx) const noexcept -> Range {
+        if (_bounds._size != 0) {
+            return { _bounds[idx], _bounds[idx + 1] };
+        }
+        let start = _range._start + idx * _step;
+        let end   = ustd::min(start + _step, _range._end);
+        return { start, end };
+    }
+};
+
+namespace parallel_impl
+{
+
+// run chunks [lo, hi): split off the upper half while more than one is left
+template<class F>
+fn run_split(Group& group, const F& f, u32 lo, u32 hi) noexcept -> void {
+    while (hi - lo > 1) {
+        let mid = lo + (hi - lo) / 2;
+        group.spawn([&group, &f, mid, hi]() {
+            run_split(group, f, mid, hi);
+        });
+        hi = mid;
+    }
+    f(lo);
+}
+
+// run chunks [0, cnt) on every worker, each claims the next unclaimed one
+template<class F>
+fn run_claim(Group& group, const F& f, u32 cnt, u32 workers) noexcept -> void {
+    mut next = 0u;
+
+    let claim = [&f, &next, cnt]() {
+        while (true) {
+            let idx = sync::fetch_and_add(&next, 1u);
+            if (idx >= cnt) break;
+            f(idx);
+        }
+    };
+
+    for (mut i = 1u; i < workers; ++i) {
+        group.spawn(claim);
+    }
+    claim();
+    group.wait();
+}
+
+template<class F>
+fn run_chunks(Pool& pool, const Chunks& chunks, Partition part, const F& f) noexcept -> void {
+    mut group = Group(pool);
+    if (part == Partition::Guided) {
+        run_claim(group, f, chunks._cnt, pool.worker_cnt() + 1);
+    }
+    else {
+        run_split(group, f, 0u, chunks._cnt);
+    }
+    group.wait();
+}
+
+}
+
+// parallel_for: body(Range sub) for disjoint sub ranges covering `range`.
+//  - grain: minimum chunk length, ranges not longer than `grain` run inline
+//  - the caller helps running chunks, so nested loops do not deadlock
+template<class F>
+fn parallel_for(Range range, u64 grain, F&& body, Partition part = Partition::Dynamic, Pool& pool = Pool::global()) noexcept -> void {
+    if (range.is_empty()) {
+        return;
+    }
+
+    grain = ustd::max(grain, u64(1));
+    if (range.len() <= grain) {
+        body(range);
+        return;
+    }
+
+    let chunks = Chunks::with_partition(range, grain, part, pool.worker_cnt() + 1);
+    if (chunks._cnt == 1) {
+        body(range);
+        return;
+    }
+
+    parallel_impl::run_chunks(pool, chunks, part, [&](u32 idx) {
+        body(chunks[idx]);
+    });
+}
+
+// parallel_reduce: fold every chunk with body(Range sub, T acc) -> T, then join the partials
+//  in range order with join(T lhs, T rhs) -> T.
+//  - `init` seeds the first chunk only, so it is folded in once
+//  - the other chunks start at `T{}`, which needs to be the identity of `join` (0 for a sum)
+//  - `join` needs to be associative, not commutative
+template<class T, class F, class J>
+fn parallel_reduce(Range range, u64 grain, T init, F&& body, J&& join, Partition part = Partition::Dynamic, Pool& pool = Pool::global()) noexcept -> T {
+    if (range.is_empty()) {
+        return init;
+    }
+
+    grain = ustd::max(grain, u64(1));
+    if (range.len() <= grain) {
+        return body(range, as_mov(init));
+    }
+
+    let chunks = Chunks::with_partition(range, grain, part, pool.worker_cnt() + 1);
+    if (chunks._cnt == 1) {
+        return body(range, as_mov(init));
+    }
+
+    mut partials = List<T>::with_capacity(chunks._cnt);
+    partials.push(as_mov(init));
+    for (mut i = 1u; i < chunks._cnt; ++i) {
+        partials.push(T{});
+    }
+
+    parallel_impl::run_chunks(pool, chunks, part, [&](u32 idx) {
+        partials[idx] = body(chunks[idx], as_mov(partials[idx]));
+    });
+
+    mut res = as_mov(partials[0]);
+    for (mut i = 1u; i < chunks._cnt; ++i) {
+        res = join(as_mov(res), as_mov(partials[i]));
+    }
+    return res;
+}
+
+// parallel_for_each: body(u64 idx) for every index
+template<class F>
+fn parallel_for_each(Range range, u64 grain, F&& body, Partition part = Partition::Dynamic, Pool& pool = Pool::global()) noexcept -> void {
+    thread::parallel_for(range, grain, [&](Range sub) {
+        for (mut i = sub._start; i < sub._end; ++i) {
+            body(i);
+        }
+    }, part, pool);
+}
+
+}
@@ -3,28 +3,397 @@
 namespace ustd::thread
 {
 
-pub fn Pool::run() noexcept -> void {
-    while (true) {
-        mut task_opt = _fns.pop();
-        if (task_opt.is_none()) {
+using sync::Ordering;
+
+// spin rounds before an idle worker parks
+static constexpr let $spin_cnt  = 64u;
+
+// upper bound of a park, guards against a missed wakeup
+static constexpr let $park_ms   = 100u;
+
+static thread_local Pool::Worker* _tls_worker = nullptr;
+
+// steal seed of threads without a worker slot, 0: not seeded yet
+static thread_local u64 _tls_seed = 0;
+
+static fn current_worker(const Pool* pool) noexcept -> Pool::Worker* {
+    let worker = _tls_worker;
+    if (worker == nullptr || worker->_pool != pool) {
+        return nullptr;
+    }
+    return worker;
+}
+
+// xorshift64
+static fn next_rand(u64& seed) noexcept -> u64 {
+    mut x = seed;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    seed = x;
+    return x;
+}
+
+static fn drop_job(Pool::job_t job) noexcept -> void {
+    mut fun = Pool::func_t::from_raw(job);
+    (void)fun;
+}
+
+#pragma region ctor/dtor
+pub Pool::Pool(u32 capacity, u32 workers) noexcept
+    : _workers{}
+    , _worker_cnt(0)
+    , _capacity(capacity)
+    , _inject(List<job_t>::with_capacity(capacity))
+    , _inject_pos(0)
+    , _inject_cnt(0)
+    , _timers(List<Timer>::with_capacity(64).as_heap())
+    , _timer_cnt(0)
+    , _sleepers(0)
+    , _pending(0)
+    , _stop(false)
+    , _threads(List<JoinHandle<void>>::with_capacity(workers))
+{
+    for (mut i = 0u; i < workers; ++i) {
+        let worker = add_worker();
+        if (worker == nullptr) {
+            log::warn("ustd::thread::Pool[{}].ctor(workers={}): limited to {} workers", this, workers, $max_workers);
             break;
         }
 
-        mut& task = task_opt._val;
-        thread::sleep_to(task._time);
-        task._fun();
+        mut thr = Builder().set_name("ustd::thread::Pool").spawn([=]() {
+            this->worker_loop(worker, true);
+        });
+        _threads.push(as_mov(thr));
+    }
+}
+
+pub Pool::~Pool() noexcept {
+    sync::store(&_stop, true, Ordering::Release);
+    unpark(true);
+
+    for (mut& thr : _threads.into_iter()) {
+        thr.join();
+    }
+    _threads.clear();
+
+    // drop jobs that never ran
+    let cnt = worker_cnt();
+    for (mut i = 0u; i < cnt; ++i) {
+        mut worker = _workers[i];
+        if (worker == nullptr) continue;
+
+        while (true) {
+            let job = worker->_deque.pop();
+            if (job.is_none()) break;
+            drop_job(job._val);
+        }
+        ustd::dtor(worker);
+        mdel(worker);
+    }
+
+    for (mut i = _inject_pos; i < _inject._size; ++i) {
+        drop_job(_inject[i]);
+    }
+
+    while (true) {
+        let timer = _timers.pop();
+        if (timer.is_none()) break;
+        drop_job(timer._val._job);
+    }
+}
+
+pub fn Pool::global() noexcept -> Pool& {
+    static mut res = Pool::with_workers(thread::available_parallelism());
+    return res;
+}
+#pragma endregion
+
+#pragma region run
+pub fn Pool::run() noexcept -> void {
+    mut worker = current_worker(this);
+    if (worker != nullptr) {
+        worker_loop(worker, false);     // nested in a job, the slot stays with the thread
+        return;
+    }
+
+    worker = add_worker();  // nullptr: out of slots, run as a helper
+    worker_loop(worker, false);
+
+    // the worker stays published, thieves may still hold it; the next caller reuses the slot
+    if (worker != nullptr) {
+        sync::store(&worker->_busy, 0u, Ordering::Release);
     }
 }
 
 pub fn Pool::async_run(str thr_name) noexcept -> JoinHandle<void> {
     let thr_info = thread::Builder().set_name(thr_name);
 
-    mut thr_join = thr_info.spawn([&]() {
+    mut thr_join = thr_info.spawn([=]() {
         this->run();
     });
     return as_mov(thr_join);
 }
 
+pub fn Pool::wait() noexcept -> void {
+    while (pending() != 0) {
+        if (try_run_one()) {
+            continue;
+        }
+        thread::yield();
+    }
+}
+
+pub fn Pool::try_run_one() noexcept -> bool {
+    let job = find_job(current_worker(this));
+    if (job == nullptr) {
+        return false;
+    }
+    exec(job);
+    return true;
+}
+
+fn Pool::add_worker() noexcept -> Worker* {
+    // a slot released by a returned `run` first
+    let cnt = worker_cnt();
+    for (mut i = 0u; i < cnt; ++i) {
+        let worker = sync::load(&_workers[i], Ordering::Acquire);
+        if (worker != nullptr && sync::compare_exchange(&worker->_busy, 0u, 1u, Ordering::Acquire)) {
+            return worker;
+        }
+    }
+
+    let idx = sync::fetch_and_add(&_worker_cnt, 1u);
+    if (idx >= $max_workers) {
+        sync::fetch_and_sub(&_worker_cnt, 1u);
+        return nullptr;
+    }
+
+    // workers live as long as the pool, `run` may be called inside an arena scope
+    let heap = Arena::Scope(nullptr);
+    let seed = 0x9E3779B97F4A7C15ull * (idx + 1);
+    mut res  = mnew<Worker>(1);
+    ustd::ctor(res, Worker{ this, idx, 1u, seed, WorkDeque<job_t>::with_capacity(_capacity) });
+
+    // thieves skip the slot until it is published
+    sync::store(&_workers[idx], res, Ordering::Release);
+    return res;
+}
+
+fn Pool::worker_loop(Worker* worker, bool persist) noexcept -> void {
+    let prev_worker = _tls_worker;
+    if (worker != nullptr) {
+        _tls_worker = worker;
+    }
+
+    mut idle = 0u;
+    while (true) {
+        let job = find_job(worker);
+        if (job != nullptr) {
+            exec(job);
+            idle = 0;
+            continue;
+        }
+
+        if (sync::load(&_stop, Ordering::Acquire)) break;
+        if (!persist && pending() == 0) break;
+
+        if (++idle < $spin_cnt) {
+            thread::yield();
+            continue;
+        }
+
+        park();
+        idle = 0;
+    }
+
+    _tls_worker = prev_worker;
+}
+#pragma endregion
+
+#pragma region push
+pub fn Pool::push_job(job_t job) noexcept -> Option<Pool&> {
+    sync::fetch_and_add(&_pending, u64(1));
+
+    mut worker = current_worker(this);
+    if (worker != nullptr) {
+        worker->_deque.push(job);
+    }
+    else {
+        mut lock = _inject_mtx.lock();
+        _inject.push(job);
+        sync::fetch_and_add(&_inject_cnt, 1u);
+    }
+
+    unpark(false);
+    return Option<Pool&>::Some(*this);
+}
+
+pub fn Pool::push_timer(job_t job, time_t time) noexcept -> Option<Pool&> {
+    sync::fetch_and_add(&_pending, u64(1));
+    {
+        mut lock = _timer_mtx.lock();
+        _timers.push(Timer{ time, job });
+        sync::fetch_and_add(&_timer_cnt, 1u);
+    }
+
+    // a parked worker may sleep past the new deadline
+    unpark(false);
+    return Option<Pool&>::Some(*this);
+}
+#pragma endregion
+
+#pragma region find
+fn Pool::find_job(Worker* worker) noexcept -> job_t {
+    // due timers first, they have waited already
+    if (sync::load(&_timer_cnt, Ordering::Relaxed) != 0) {
+        let job = pop_timer();
+        if (job != nullptr) return job;
+    }
+
+    if (worker != nullptr) {
+        let job = worker->_deque.pop();
+        if (job.is_some()) return job._val;
+    }
+
+    if (sync::load(&_inject_cnt, Ordering::Relaxed) != 0) {
+        let job = pop_inject();
+        if (job != nullptr) return job;
+    }
+
+    return steal(worker);
+}
+
+fn Pool::pop_inject() noexcept -> job_t {
+    mut lock = _inject_mtx.lock();
+    if (_inject_pos == _inject._size) {
+        return nullptr;
+    }
+
+    let job = _inject[_inject_pos++];
+    sync::fetch_and_sub(&_inject_cnt, 1u);
+
+    // drop the consumed prefix once it is the larger half: the rest does not overlap it,
+    //  and a queue that never drains under steady submission stays bounded
+    if (_inject_pos * 2 > _inject._size) {
+        let rem = _inject._size - _inject_pos;
+        mcpy(_inject._data, _inject._data + _inject_pos, rem);
+        _inject_pos   = 0;
+        _inject._size = rem;
+    }
+    return job;
+}
+
+fn Pool::pop_timer() noexcept -> job_t {
+    mut lock = _timer_mtx.lock();
+
+    let top = _timers.top();
+    if (top.is_none() || time_t::now() < top._val._time) {
+        return nullptr;
+    }
+
+    let timer = _timers.pop();
+    sync::fetch_and_sub(&_timer_cnt, 1u);
+    return timer._val._job;
+}
+
+fn Pool::steal(Worker* worker) noexcept -> job_t {
+    let cnt = worker_cnt();
+    if (cnt == 0) {
+        return nullptr;
+    }
+
+    // helpers start at a random victim too, so they do not all hit the first worker
+    mut& seed = worker != nullptr ? worker->_seed : _tls_seed;
+    if (seed == 0) {
+        seed = (u64(&_tls_seed) * 0x9E3779B97F4A7C15ull) | 1u;
+    }
+    let from = u32(next_rand(seed) % cnt);
+
+    for (mut i = 0u; i < cnt; ++i) {
+        let idx    = (from + i) % cnt;
+        let victim = sync::load(&_workers[idx], Ordering::Acquire);
+        if (victim == nullptr || victim == worker) continue;
+
+        let job = victim->_deque.steal();
+        if (job.is_some()) return job._val;
+    }
+    return nullptr;
+}
+
+fn Pool::exec(job_t job) noexcept -> void {
+    {
+        mut fun = func_t::from_raw(job);
+        try {
+            fun();
+        }
+        catch (...) {
+            log::error("ustd::thread::Pool[{}].exec(): job panicked", this);
+        }
+    }
+
+    let rem = sync::fetch_and_sub(&_pending, u64(1)) - 1;
+    if (rem == 0) {
+        unpark(true);   // wake `run` and `wait` callers
+    }
+}
+#pragma endregion
+
+#pragma region park
+fn Pool::has_work() noexcept -> bool {
+    if (sync::load(&_inject_cnt) != 0) return true;
+
+    let cnt = worker_cnt();
+    for (mut i = 0u; i < cnt; ++i) {
+        let worker = sync::load(&_workers[i], Ordering::Acquire);
+        if (worker != nullptr && !worker->_deque.is_empty()) return true;
+    }
+
+    if (sync::load(&_timer_cnt) != 0) {
+        mut lock = _timer_mtx.lock();
+        let top  = _timers.top();
+        if (top.is_some() && top._val._time <= time_t::now()) return true;
+    }
+    return false;
+}
+
+fn Pool::park() noexcept -> void {
+    mut lock = _park_mtx.lock().unwrap();
+    sync::fetch_and_add(&_sleepers, 1u);
+
+    // pairs with the fence in `unpark`: either we see the job, or the pusher sees us
+    sync::fence(Ordering::SeqCst);
+
+    let stop = sync::load(&_stop, Ordering::Acquire);
+    if (!stop && !has_work()) {
+        mut timeout = time::Duration::from_millis($park_ms);
+        {
+            mut timer_lock = _timer_mtx.lock();
+            let top = _timers.top();
+            if (top.is_some()) {
+                let now = time_t::now();
+                let due = top._val._time;
+                let dur = due <= now ? time::Duration::from_millis(0) : due - now;
+                if (dur < timeout) timeout = dur;
+            }
+        }
+        _park_cnd.wait_timeout(lock, timeout);
+    }
+
+    sync::fetch_and_sub(&_sleepers, 1u);
+}
+
+fn Pool::unpark(bool all) noexcept -> void {
+    sync::fence(Ordering::SeqCst);
+    if (sync::load(&_sleepers, Ordering::Relaxed) == 0) {
+        return;
+    }
+
+    mut lock = _park_mtx.lock();
+    all ? _park_cnd.notify_all() : _park_cnd.notify_one();
+}
+#pragma endregion
+
 unittest(Pool) {
     mut pool = Pool::with_capacity(4096);
 
@@ -42,4 +411,63 @@ unittest(Pool) {
     t1.join();
 }
 
+unittest(Pool_run) {
+    mut pool = Pool::with_capacity(64);
+
+    // each call takes the slot the previous one released
+    mut cnt = 0u;
+    for (mut i = 0u; i < 100u; ++i) {
+        pool.push([&] {
+            sync::fetch_and_add(&cnt, 1u);
+        });
+        pool.run();
+    }
+    assert_eq(cnt, 100u);
+    assert_eq(pool.worker_cnt(), 1u);
+}
+
+unittest(Pool_inject) {
+    mut pool = Pool::with_capacity(64);
+
+    // 100 queued, then 1 in 1 out: the queue never drains, the consumed prefix is still dropped
+    mut cnt = 0u;
+    for (mut i = 0u; i < 100u; ++i) {
+        pool.push([&] { cnt += 1; });
+    }
+    for (mut i = 0u; i < 10000u; ++i) {
+        pool.push([&] { cnt += 1; });
+        pool.try_run_one();
+        assert_eq(pool._inject._size <= 202, true);
+    }
+
+    pool.wait();
+    assert_eq(cnt, 10100u);
+}
+
+unittest(Pool_steal) {
+    mut pool = Pool::with_workers(thread::available_parallelism());
+
+    let outer = 64u;
+    let inner = 1024u;
+    mut cnt   = 0u;
+
+    // fan-out from inside workers, so jobs land in the worker deques
+    for (mut i = 0u; i < outer; ++i) {
+        pool.push([&] {
+            for (mut k = 0u; k < inner; ++k) {
+                pool.push([&] {
+                    sync::fetch_and_add(&cnt, 1u);
+                });
+            }
+        });
+    }
+
+    let t0 = time::Instant::now();
+    pool.wait();
+    let t1 = time::Instant::now();
+
+    assert_eq(cnt, outer * inner);
+    log::info("ustd::thread::Pool[workers={}]: {} jobs in {}", pool.worker_cnt(), outer * inner, t1 - t0);
+}
+
 }
@@ -2,78 +2,162 @@
 
 #include "ustd/core.h"
 #include "ustd/time.h"
+#include "ustd/sync/atomic.h"
+#include "ustd/sync/mutex.h"
+#include "ustd/sync/condvar.h"
 #include "ustd/thread/thread.h"
+#include "ustd/thread/deque.h"
 
 namespace ustd::thread
 {
 
+// work-stealing thread pool
+//  - every worker owns a Chase-Lev deque, jobs pushed from a worker go there
+//  - jobs pushed from other threads go to the inject queue
+//  - idle workers steal from random victims, then park on the idle event
+//  - delayed jobs live in a timer heap until they are due
 class Pool
 {
 public:
-    using func_t = Fn<void()>;
+    using func_t = FnBox<void()>;
+    using job_t  = func_t::res_t*;
     using time_t = time::Instant;
 
-    struct AsyncFn
-    {
-        time_t _time;
-        func_t _fun;
+    constexpr static let $max_workers   = 256u;
+    constexpr static let $default_cap   = 1024u;
 
-        AsyncFn(time_t time, func_t&& fun)
-            : _time(time)
-            , _fun(as_mov(fun))
-        {}
+    struct Timer
+    {
+        time_t  _time;
+        job_t   _job;
 
-        fn operator<(const AsyncFn& other) const noexcept -> bool {
+        fn operator<(const Timer& other) const noexcept -> bool {
             return _time < other._time;
         }
 
-        fn operator<=(const AsyncFn& other) const noexcept -> bool {
+        fn operator<=(const Timer& other) const noexcept -> bool {
             return _time <= other._time;
         }
     };
 
+    struct Worker
+    {
+        Pool*               _pool;
+        u32                 _index;
+        u32                 _busy;      // atomic, a thread runs the slot; `run` frees it on return
+        u64                 _seed;
+        WorkDeque<job_t>    _deque;
+    };
+
 public:
-    Heap<AsyncFn>   _fns;
+    Worker*                 _workers[$max_workers];
+    u32                     _worker_cnt;    // atomic
+    u32                     _capacity;
+
+    sync::Mutex             _inject_mtx;
+    List<job_t>             _inject;
+    u32                     _inject_pos;
+    u32                     _inject_cnt;    // atomic
 
-    Pool(Pool&& other) noexcept
-        : _fns(as_mov(other._fns))
-    {}
+    sync::Mutex             _timer_mtx;
+    Heap<Timer>             _timers;
+    u32                     _timer_cnt;     // atomic
 
-    ~Pool() noexcept
-    {}
+    sync::Mutex             _park_mtx;
+    sync::CondVar           _park_cnd;
+    u32                     _sleepers;      // atomic
 
+    u64                     _pending;       // atomic, queued + running jobs
+    bool                    _stop;          // atomic
+    List<JoinHandle<void>>  _threads;
+
+    // workers capture `this`, so a pool cannot move.
+    Pool(Pool&&) = delete;
+
+    pub ~Pool() noexcept;
+
+    // ctor: no background workers, call `run` or `async_run` to drain the pool.
     static fn with_capacity(u32 capacity) noexcept -> Pool {
-        return Pool(capacity);
+        let heap = Arena::Scope(nullptr);   // the pool outlives the caller's arena
+        return Pool(capacity, 0);
+    }
+
+    // ctor: `cnt` background workers, alive until the pool is dropped.
+    static fn with_workers(u32 cnt, u32 capacity = $default_cap) noexcept -> Pool {
+        let heap = Arena::Scope(nullptr);   // the pool outlives the caller's arena
+        return Pool(capacity, cnt);
+    }
+
+    // the process-wide pool, one worker per cpu.
+    static pub fn global() noexcept -> Pool&;
+
+    // property[r]: number of registered workers
+    fn worker_cnt() const noexcept -> u32 {
+        return sync::load(&_worker_cnt, sync::Ordering::Acquire);
+    }
+
+    // property[r]: number of queued + running jobs
+    fn pending() const noexcept -> u64 {
+        return sync::load(&_pending, sync::Ordering::Acquire);
     }
 
+    // method: join as a worker until all jobs are done, the worker slot is released on return
     pub fn run()                    noexcept -> void;
+
+    // method: spawn a thread that runs `run`
     pub fn async_run(str thr_name)  noexcept -> JoinHandle<void>;
 
+    // method: help running jobs until all jobs are done
+    pub fn wait()                   noexcept -> void;
+
+    // method: run at most one job on the calling thread
+    pub fn try_run_one()            noexcept -> bool;
+
     template<class F>
     fn push(F&& f, time_t time) noexcept -> Option<Pool&> {
-        return push_fn(func_t::from_fn(as_fwd<F>(f)), time);
+        let heap = Arena::Scope(nullptr);   // jobs are dropped on the worker
+        mut fun  = func_t::from_fn(as_fwd<F>(f));
+        let job = fun._res;
+        fun.forget();
+        return push_timer(job, time);
     }
 
     template<class F>
     fn push(F&& f, time::Duration dur) noexcept -> Option<Pool&> {
+        if (dur._secs == 0 && dur._nanos == 0) {
+            return this->push(as_fwd<F>(f));
+        }
         let time = time_t::now() + dur;
-        return this->push(func_t::from_fn(as_fwd<F>(f)), time);
+        return this->push(as_fwd<F>(f), time);
     }
 
     template<class F>
     fn push(F&& f) noexcept -> Option<Pool&> {
-        return push(func_t::from_fn(as_fwd<F>(f)), time::Duration(0, 0));
+        let heap = Arena::Scope(nullptr);   // jobs are dropped on the worker
+        mut fun  = func_t::from_fn(as_fwd<F>(f));
+        let job = fun._res;
+        fun.forget();
+        return push_job(job);
     }
 
 private:
-    explicit Pool(u32 capacity) noexcept
-        : _fns(List<AsyncFn>::with_capacity(capacity).as_heap())
-    {}
+    pub Pool(u32 capacity, u32 workers) noexcept;
 
-    fn push_fn(func_t&& fun, time_t time) noexcept -> Option<Pool&> {
-        mut res = _fns.push(AsyncFn{ time, as_mov(fun) });
-        return res & Option<Pool&>::Some(*this);
-    }
+    pub fn push_job(job_t job)                  noexcept -> Option<Pool&>;
+    pub fn push_timer(job_t job, time_t time)   noexcept -> Option<Pool&>;
+
+    fn add_worker()                         noexcept -> Worker*;
+    fn worker_loop(Worker* worker, bool persist) noexcept -> void;
+
+    fn find_job(Worker* worker)             noexcept -> job_t;
+    fn pop_inject()                         noexcept -> job_t;
+    fn pop_timer()                          noexcept -> job_t;
+    fn steal(Worker* worker)                noexcept -> job_t;
+    fn exec(job_t job)                      noexcept -> void;
+
+    fn has_work()                           noexcept -> bool;
+    fn park()                               noexcept -> void;
+    fn unpark(bool all)                     noexcept -> void;
 };
 
 }
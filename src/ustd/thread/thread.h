@@ -101,7 +101,8 @@ struct Builder
     template<class F, class R = decltype(declval<val_t<F>>()()) >
     fn spawn(F&& f) const noexcept -> JoinHandle<R> {
         if constexpr($is_same<R, void>) {
-            mut fun = FnBox<R()>::from_fn(as_fwd<F>(f));
+            let heap = Arena::Scope(nullptr);
+            mut fun  = FnBox<R()>::from_fn(as_fwd<F>(f));
             mut thr = this->spawn_fn(fun._res);
             return JoinHandle<R>(thr, as_mov(fun));
         }
@@ -6,8 +6,23 @@ add_rules("mode.debug", "mode.release")
 add_cxflags("-std=c++17", "-fms-extensions")
 add_includedirs("src/")
 
+-- options: allocation counters, see `ustd::mem_stats`
+option("mem_stats")
+    set_default(false)
+    set_showmenu(true)
+    add_defines("USTD_MEM_STATS=1")
+option_end()
+
+-- options: 64 bit lengths of Slice, List and String, every target must agree
+option("size64")
+    set_default(false)
+    set_showmenu(true)
+    add_defines("USTD_SIZE64=1")
+option_end()
+
 target("ustd")
     set_kind("shared")
+    add_options("mem_stats", "size64")
     add_files("src/**.cc") 
     del_files("src/**/main.cc")
 
@@ -15,4 +30,5 @@ target("ustd")
 target("ustd.test")
     set_kind("binary")
     add_deps("ustd")
+    add_options("size64")
     add_files("src/ustd/test/main.cc")